@@ -2,82 +2,345 @@
 #define TTP_BASE_H
 
 #include "reader.cpp"
+#include "ttp_evaluator.h"
+#include "ttp_delta.h"
+#include "ttp_dontlook.h"
+#include "ttp_island.h"
+#include "ttp_lk.h"
+#include "ttp_metrics.h"
+#include "ttp_moves.h"
+#include "ttp_packing.h"
+#include "ttp_parallel.h"
+#include "ttp_rng.h"
+#include "ttp_sink.h"
+#include "ttp_solution.h"
+#include "ttp_timer.h"
 #include <vector>
 #include <string>
 #include <limits>
 #include <algorithm>
 #include <cmath>
+#include <memory>
+#include <ctime>
+#include <fstream>
 
 using namespace std;
 
-struct TTPSolution {
-    vector<int> tour;       
-    vector<int> pickingPlan;   
-    double objective;         
-    double profit;           
-    double time;              
-    int weight;                 
-    
-    TTPSolution() : objective(-numeric_limits<double>::infinity()), 
-                    profit(0), time(0), weight(0) {}
+// ============================================================
+// ESPACIO DE TRABAJO REUTILIZABLE
+// ============================================================
+// Buffers y evaluadores incrementales que las búsquedas reinicializan en
+// cada iteración en lugar de crearlos de nuevo: tras la primera iteración
+// ya tienen la capacidad necesaria y el bucle principal no vuelve a pedir
+// memoria. Cada copia de una heurística (clone) tiene el suyo.
+struct SearchWorkspace {
+    TourMoveEvaluator moves;
+    PickingDeltaEvaluator picking;
+    PackingPlanner packing;
+    LinKernighan lk;
+    vector<double> remaining;           // distancia desde cada ciudad hasta el final del tour
+    DirtyQueue dirty;                   // ciudades pendientes de la búsqueda local del tour
+    PickingPlan previousPlan;           // plan antes de re-optimizar el picking
+    vector<int> batchItems;             // items de un lote de flipDeltaBatch
+    vector<pair<double, int>> blockBest;   // mejor flip de cada bloque del barrido paralelo
+    vector<int> blockTried;             // flips evaluados en cada bloque del barrido paralelo
     
-    bool isValid(const TTPInstance& inst) const {
-        return weight <= inst.capacity && tour.size() == (size_t)inst.dimension;
-    }
+    SearchWorkspace(const TTPInstance& inst) : moves(inst), picking(inst), packing(inst), lk(inst) {}
+};
+
+// operadores de improveTour (se combinan con |)
+enum TourOperator {
+    TOUR_2OPT = 1,      // invertir un tramo
+    TOUR_OROPT = 2,     // mover un segmento de hasta maxSegmentSize ciudades
+    TOUR_OR3OPT = 4,    // mover un segmento e insertarlo invertido
+    TOUR_ALL = 7
 };
 
 class TTPHeuristic {
 protected:
     const TTPInstance& instance;
+    TTPEvaluator evaluator;
+    SearchWorkspace work;
+    Xoshiro256 rng;    // generador propio de cada heurística (y de cada copia)
+    Deadline deadline; // presupuesto de tiempo de la ejecución actual
+    LazyThreadPool searchPool;   // hilos para paralelizar dentro de una búsqueda
+    int islands;       // trayectorias en paralelo (modelo de islas), en las heurísticas que lo soportan
+    SearchCounters counters;     // evaluaciones, movimientos y tiempo por fase de la ejecución actual
+    shared_ptr<const TTPSolution> warmStart;   // solución inicial cargada (nullptr: construir)
+    bool warmStartItems;         // el warm start trae plan de recogida, no solo tour
+    
+    // mejor objetivo encontrado a lo largo de la ejecución: (segundos, objetivo)
+    vector<pair<double, double>> trajectory;
+    
+    // entero uniforme en [0, n)
+    int randomInt(int n) {
+        return rng.nextInt(n);
+    }
+    
+    // real uniforme en [0, 1)
+    double randomDouble() {
+        return rng.nextDouble();
+    }
+    
+    // comprobación barata para los bucles internos de las búsquedas locales
+    bool timeUp() {
+        return deadline.expired();
+    }
+    
+    // condición de los bucles principales: sin límite de tiempo se hacen
+    // maxIter iteraciones; con límite se sigue hasta agotarlo
+    bool keepIterating(int iter, int maxIter) {
+        if (deadline.isLimited()) return !deadline.expiredNow();
+        return iter < maxIter;
+    }
+    
+    // Tour inicial de las heurísticas que admiten warm start: el cargado con
+    // setWarmStart o, si no hay, el que construye 'build'. Devuelve true si
+    // también se copió el plan de recogida; si no, quien llama lo construye.
+    template <typename Build>
+    bool initialTour(TTPSolution& sol, Build build) {
+        if (!warmStart) {
+            sol.tour = build();
+            return false;
+        }
+        sol.tour = warmStart->tour;
+        if (!warmStartItems) return false;
+        sol.pickingPlan = warmStart->pickingPlan;
+        return true;
+    }
+    
+    // anotar sol en la trayectoria si mejora lo mejor visto hasta ahora
+    void recordBest(const TTPSolution& sol) {
+        if (trajectory.empty() || sol.objective > trajectory.back().second) {
+            trajectory.push_back({deadline.elapsed(), sol.objective});
+        }
+    }
     
 public:
-    TTPHeuristic(const TTPInstance& inst) : instance(inst) {}
+    TTPHeuristic(const TTPInstance& inst)
+        : instance(inst), evaluator(inst), work(inst), islands(1), warmStartItems(false) {}
     virtual ~TTPHeuristic() {}
     
     virtual TTPSolution solve() = 0;
     virtual string getName() const = 0;
     
+    // copia independiente (con su propio generador y buffers) para que
+    // varias ejecuciones puedan correr a la vez en distintos hilos
+    virtual TTPHeuristic* clone() const = 0;
+    
+    void setSeed(uint64_t seed) {
+        rng.seedWith(seed);
+    }
+    
+    // número de islas de las búsquedas que lo soportan (BalancedLNS,
+    // BalancedVNS); 1 = una sola trayectoria
+    void setIslands(int count) {
+        islands = max(1, count);
+    }
+    
+    // hilos que puede usar una búsqueda para repartir sus barridos (1 = en
+    // el hilo actual); cada clon crea su propio pool
+    void setSearchThreads(int threads) {
+        searchPool.setThreads(max(1, threads));
+    }
+    
+    // Empezar desde una solución ya validada (loadWarmStart en
+    // ttp_solution.h) en lugar de construirla: la usan HillClimbingPicking,
+    // ImprovedHillClimbing, BalancedLNS y BalancedVNS. Con withItems = false
+    // solo se toma el tour. Las copias (clone) comparten la solución.
+    void setWarmStart(const TTPSolution& sol, bool withItems) {
+        warmStart = make_shared<const TTPSolution>(sol);
+        warmStartItems = withItems;
+    }
+    
+    // empezar a contar el tiempo de una ejecución (seconds <= 0: sin límite)
+    void startClock(double seconds) {
+        deadline.restart(seconds);
+        trajectory.clear();
+        counters.clear();
+    }
+    
+    const vector<pair<double, double>>& getTrajectory() const {
+        return trajectory;
+    }
+    
+    const SearchCounters& getCounters() const {
+        return counters;
+    }
+    
     void evaluateSolution(TTPSolution& sol) {
-        sol.profit = 0.0;
-        sol.time = 0.0;
-        sol.weight = 0;
+        counters.evaluations++;
+        TTPEvaluation ev = evaluator.evaluate(sol.tour, sol.pickingPlan);
+        sol.objective = ev.objective;
+        sol.profit = ev.profit;
+        sol.time = ev.time;
+        sol.weight = ev.weight;
+    }
+    
+    // 2-Opt alrededor de la ciudad a: el nuevo arco a-c (c entre sus vecinos
+    // cercanos) reemplaza la arista de a con su sucesor y la de c con el
+    // suyo, o las de ambos con su predecesor. Se aplica el primer movimiento
+    // que mejora y se marcan pendientes los extremos de las aristas nuevas.
+    bool try2OptAround(vector<int>& tour, int a, int numNeighbors) {
+        TourMoveEvaluator& moves = work.moves;
+        int n = tour.size();
+        int p = moves.positionOf(a);
+        const int* near = &instance.candidates[(size_t)a * instance.num_candidates];
         
-        for (int i = 0; i < instance.num_items; i++) {
-            if (sol.pickingPlan[i] == 1) {
-                sol.profit += instance.items[i].profit;
-                sol.weight += instance.items[i].weight;
+        for (int t = 0; t < numNeighbors; t++) {
+            int pc = moves.positionOf(near[t]);
+            for (int side = 0; side < 2; side++) {
+                int lo, hi;
+                if (side == 0) {
+                    lo = min(p, pc) + 1;
+                    hi = max(p, pc);
+                } else {
+                    lo = min(p, pc);
+                    hi = max(p, pc) - 1;
+                }
+                if (lo < 1 || hi <= lo) continue;
+                
+                int before = tour[lo - 1];
+                int after = tour[(hi + 1) % n];
+                double distDelta = instance.distances(before, tour[hi]) +
+                                   instance.distances(tour[lo], after) -
+                                   instance.distances(before, tour[lo]) -
+                                   instance.distances(tour[hi], after);
+                if (distDelta >= 0) continue;
+                
+                counters.tried[OP_2OPT]++;
+                if (moves.twoOptDelta(tour, lo, hi) > 1e-9) {
+                    moves.applyTwoOpt(tour, lo, hi);
+                    counters.accepted[OP_2OPT]++;
+                    work.dirty.push(before);
+                    work.dirty.push(tour[lo]);
+                    work.dirty.push(tour[hi]);
+                    work.dirty.push(after);
+                    return true;
+                }
             }
         }
-
-        if (sol.weight > instance.capacity) {
-            sol.objective = -1e9;
-            sol.time = 1e9;
-            return;
-        }
-
-        double nu = (instance.max_speed - instance.min_speed) / instance.capacity;
-
-        int currentWeight = 0;
-        for (int i = 0; i < instance.dimension; i++) {
-            int from = sol.tour[i];
-            int to = sol.tour[(i + 1) % instance.dimension];
+        return false;
+    }
+    
+    // Or-opt (o Or-3opt con reversed) del segmento tour[i..i+segSize-1]:
+    // se prueba insertarlo detrás de un vecino de su nueva primera ciudad o
+    // delante de un vecino de la última. Solo se evalúan en TTP las
+    // inserciones que acortan el tour; el tiempo se estima en O(1) con
+    // orOptDeltaFast y se confirma con la evaluación exacta.
+    bool tryMoveSegment(vector<int>& tour, int i, int segSize, bool reversed, int numNeighbors) {
+        TourMoveEvaluator& moves = work.moves;
+        int n = tour.size();
+        int K = instance.num_candidates;
+        SearchOperator op = reversed ? OP_OR3OPT : OP_OROPT;
+        
+        int first = tour[i];
+        int last = tour[i + segSize - 1];
+        int prev = tour[i - 1];
+        int next = tour[(i + segSize) % n];
+        int head = reversed ? last : first;   // extremos en el nuevo sentido
+        int tail = reversed ? first : last;
+        double removeGain = instance.distances(prev, next) -
+                            instance.distances(prev, first) -
+                            instance.distances(last, next);
+        
+        for (int t = 0; t < 2 * numNeighbors; t++) {
+            int c = (t < numNeighbors) ? instance.candidates[(size_t)head * K + t]
+                                       : instance.candidates[(size_t)tail * K + t - numNeighbors];
+            int pc = moves.positionOf(c);
+            if (pc >= i && pc < i + segSize) continue;
             
-            double velocity = instance.max_speed - nu * currentWeight;
-
-            if (velocity < instance.min_speed) {
-                velocity = instance.min_speed;
-            }
-
-            sol.time += instance.distances[from][to] / velocity;
+            int j = (t < numNeighbors) ? pc + 1 : pc;
+            if (j == 0 || (j >= i && j <= i + segSize)) continue;
             
-            for (int k = 0; k < instance.num_items; k++) {
-                if (sol.pickingPlan[k] == 1 && instance.items[k].node == to) {
-                    currentWeight += instance.items[k].weight;
-                }
+            int u = tour[j - 1];
+            int v = tour[j % n];
+            double distDelta = removeGain + instance.distances(u, head) +
+                               instance.distances(tail, v) - instance.distances(u, v);
+            if (distDelta >= 0) continue;
+            
+            counters.tried[op]++;
+            if (moves.orOptDeltaFast(tour, i, segSize, j, reversed) > 1e-9 &&
+                moves.orOptDelta(tour, i, segSize, j, reversed) > 1e-9) {
+                moves.applyOrOpt(tour, i, segSize, j, reversed);
+                counters.accepted[op]++;
+                for (int city : {prev, next, first, last, u, v}) work.dirty.push(city);
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // segmentos de 1..maxSegmentSize ciudades que empiezan o terminan en a
+    // (los de una ciudad no se invierten: serían el mismo Or-opt)
+    bool tryOrOptAround(vector<int>& tour, int a, int maxSegmentSize, bool reversed, int numNeighbors) {
+        int n = tour.size();
+        int p = work.moves.positionOf(a);
+        for (int segSize = reversed ? 2 : 1; segSize <= maxSegmentSize; segSize++) {
+            for (int i : {p, p - segSize + 1}) {
+                if (i < 1 || i + segSize > n) continue;
+                if (tryMoveSegment(tour, i, segSize, reversed, numNeighbors)) return true;
+                if (segSize == 1) break;
+            }
+        }
+        return false;
+    }
+    
+    // Búsqueda local del tour con don't-look bits: se sacan ciudades de la
+    // cola work.dirty y se prueban los operadores pedidos alrededor de cada
+    // una (primera mejora). Un movimiento aplicado vuelve a encolar solo los
+    // extremos de las aristas que cambió, así que cuando quedan pocas
+    // mejoras el costo es proporcional a lo que cambia y no a n * vecinos.
+    // Termina cuando la cola se vacía (óptimo local) o se acaba el tiempo.
+    // Con keepQueue se usa la cola tal como está (quien llama marcó las
+    // ciudades pendientes); si no, se encolan todas.
+    bool improveTour(TTPSolution& sol, int operators, int maxNeighbors,
+                     int maxSegmentSize = 3, bool keepQueue = false) {
+        PhaseTimer timer(counters, PHASE_TOUR);
+        int numNeighbors = min(maxNeighbors, instance.num_candidates);
+        work.moves.reset(sol.tour, sol.pickingPlan);
+        if (!keepQueue) work.dirty.fill(sol.tour);
+        
+        bool improved = false;
+        while (!work.dirty.empty() && !timeUp()) {
+            int a = work.dirty.pop();
+            if (((operators & TOUR_2OPT) && try2OptAround(sol.tour, a, numNeighbors)) ||
+                ((operators & TOUR_OROPT) && tryOrOptAround(sol.tour, a, maxSegmentSize, false, numNeighbors)) ||
+                ((operators & TOUR_OR3OPT) && tryOrOptAround(sol.tour, a, maxSegmentSize, true, numNeighbors))) {
+                improved = true;
             }
         }
         
-        sol.objective = sol.profit - sol.time * instance.renting_ratio;
+        if (improved) evaluateSolution(sol);
+        return improved;
+    }
+    
+    // marcar pendiente la ciudad de la posición p y sus dos vecinas en el tour
+    void markAround(const vector<int>& tour, int p) {
+        int n = tour.size();
+        work.dirty.push(tour[(p + n - 1) % n]);
+        work.dirty.push(tour[p]);
+        work.dirty.push(tour[(p + 1) % n]);
+    }
+    
+    // marcar pendientes las ciudades cuyos items cambiaron entre dos planes
+    void markChangedItems(const PickingPlan& before, const PickingPlan& after) {
+        before.forEachDifferent(after, [&](int k) {
+            work.dirty.push(instance.item_node[k]);
+        });
+    }
+    
+    // 2-Opt limitado a vecinos geométricos: para cada ciudad se prueban como
+    // nuevo vecino sus maxNeighbors ciudades más cercanas, hasta que ninguna
+    // inversión mejora.
+    bool improve2OptLimited(TTPSolution& sol, int maxNeighbors = 20) {
+        return improveTour(sol, TOUR_2OPT, maxNeighbors);
+    }
+    
+    // Or-Opt: mueve segmentos de 1 a maxSegmentSize ciudades junto a las
+    // ciudades más cercanas a sus extremos, hasta que ninguno mejora.
+    bool improveOrOpt(TTPSolution& sol, int maxSegmentSize = 3) {
+        return improveTour(sol, TOUR_OROPT, instance.num_candidates, maxSegmentSize);
     }
     
     vector<int> createSequentialTour() {
@@ -88,104 +351,214 @@ public:
         return tour;
     }
     
+    // Fisher-Yates con randomInt en vez de std::shuffle, cuyo algoritmo
+    // depende de la biblioteca estándar: así la misma semilla da el mismo
+    // tour en cualquier plataforma
     vector<int> createRandomTour() {
+        PhaseTimer timer(counters, PHASE_CONSTRUCTION);
         vector<int> tour = createSequentialTour();
-        random_shuffle(tour.begin() + 1, tour.end());
+        for (int i = tour.size() - 1; i > 1; i--) {
+            swap(tour[i], tour[1 + randomInt(i)]);
+        }
         return tour;
     }
     
+    // vecino más cercano con un árbol k-d: cada paso pide la ciudad no
+    // visitada más cercana (mismo desempate por índice que un barrido lineal)
     vector<int> createNearestNeighborTour(int start = 0) {
+        PhaseTimer timer(counters, PHASE_CONSTRUCTION);
         vector<int> tour;
-        vector<bool> visited(instance.dimension, false);
+        tour.reserve(instance.dimension);
+        KDTree tree(instance.distances);
         
         int current = start;
         tour.push_back(current);
-        visited[current] = true;
+        tree.remove(current);
         
         for (int i = 1; i < instance.dimension; i++) {
-            double minDist = numeric_limits<double>::infinity();
-            int nearest = -1;
-            
-            for (int j = 0; j < instance.dimension; j++) {
-                if (!visited[j] && instance.distances[current][j] < minDist) {
-                    minDist = instance.distances[current][j];
-                    nearest = j;
-                }
-            }
+            int nearest = tree.nearestAlive(current);
             
             tour.push_back(nearest);
-            visited[nearest] = true;
+            tree.remove(nearest);
             current = nearest;
         }
         
         return tour;
     }
     
-    vector<int> createEmptyPickingPlan() {
-        return vector<int>(instance.num_items, 0);
+    // Componente TSP con Lin-Kernighan encadenado (ttp_lk.h): mejora el largo
+    // del tour (sin mirar los items) con 'kicks' patadas, o menos si se
+    // acaba el tiempo; kicks < 0 usa 10 por ciudad. Conserva tour[0].
+    double improveTourLK(vector<int>& tour, int kicks = -1) {
+        PhaseTimer timer(counters, PHASE_TOUR);
+        if (kicks < 0) kicks = 10 * instance.dimension;
+        return work.lk.optimize(tour, kicks, rng, deadline);
     }
     
-    vector<int> createGreedyPickingPlan(const vector<int>& tour) {
-        vector<int> pickingPlan(instance.num_items, 0);
-        
-        vector<pair<double, int>> itemRatios;
-        for (int i = 0; i < instance.num_items; i++) {
-            double ratio = (double)instance.items[i].profit / instance.items[i].weight;
-            itemRatios.push_back({ratio, i});
-        }
-        sort(itemRatios.rbegin(), itemRatios.rend());
+    // tour de vecino más cercano mejorado con improveTourLK
+    vector<int> createLinKernighanTour(int start = 0, int kicks = -1) {
+        vector<int> tour = createNearestNeighborTour(start);
+        improveTourLK(tour, kicks);
+        return tour;
+    }
+    
+    // vecino más cercano empezando a construir desde 'start', rotado para
+    // que el tour siga saliendo de la ciudad 0
+    vector<int> createNearestNeighborTourFrom(int start) {
+        vector<int> tour = createNearestNeighborTour(start);
+        rotate(tour.begin(), find(tour.begin(), tour.end(), 0), tour.end());
+        return tour;
+    }
+    
+    PickingPlan createEmptyPickingPlan() {
+        return PickingPlan(instance.num_items);
+    }
+    
+    PickingPlan createGreedyPickingPlan(const vector<int>& tour) {
+        PickingPlan pickingPlan;
+        fillGreedyPickingPlan(tour, pickingPlan);
+        return pickingPlan;
+    }
+    
+    // igual que createGreedyPickingPlan pero escribiendo en un plan existente
+    void fillGreedyPickingPlan(const vector<int>& tour, PickingPlan& pickingPlan) {
+        PhaseTimer timer(counters, PHASE_PACKING);
+        pickingPlan.assign(instance.num_items);
 
         int currentWeight = 0;
-        for (auto& p : itemRatios) {
-            int itemIdx = p.second;
-            if (currentWeight + instance.items[itemIdx].weight <= instance.capacity) {
-                pickingPlan[itemIdx] = 1;
-                currentWeight += instance.items[itemIdx].weight;
+        for (int itemIdx : instance.item_order) {
+            if (currentWeight + instance.item_weight[itemIdx] <= instance.capacity) {
+                pickingPlan.set(itemIdx);
+                currentWeight += instance.item_weight[itemIdx];
             }
         }
+    }
+    
+    // plan según el tour con la búsqueda de PackingPlanner (ttp_packing.h);
+    // puede invertir el sentido del tour si así se consigue un plan mejor.
+    // Si el tour cambió poco desde la llamada anterior la búsqueda es corta.
+    void fillPackedPickingPlan(vector<int>& tour, PickingPlan& pickingPlan) {
+        PhaseTimer timer(counters, PHASE_PACKING);
+        work.packing.packTour(tour, pickingPlan);
+    }
+    
+    // Variante voraz que tiene en cuenta el tour: recorre los items en el
+    // mismo orden por ratio, pero solo toma un item si su ganancia supera el
+    // costo de alquiler de llevar su peso desde su ciudad hasta el final,
+    // estimado con la velocidad que da el peso ya recogido.
+    void fillTourAwarePickingPlan(const vector<int>& tour, PickingPlan& pickingPlan) {
+        PhaseTimer timer(counters, PHASE_PACKING);
+        pickingPlan.assign(instance.num_items);
         
-        return pickingPlan;
+        int n = tour.size();
+        vector<double>& remaining = work.remaining;
+        remaining.assign(instance.dimension, 0.0);
+        for (int i = n - 1; i >= 1; i--) {
+            remaining[tour[i]] = remaining[tour[(i + 1) % n]] + instance.distances(tour[i], tour[(i + 1) % n]);
+        }
+        remaining[tour[0]] = 0;   // lo de la ciudad inicial nunca viaja
+        
+        double nu = (instance.max_speed - instance.min_speed) / instance.capacity;
+        auto velocity = [&](int w) { return max(instance.max_speed - nu * w, instance.min_speed); };
+        
+        int currentWeight = 0;
+        for (int itemIdx : instance.item_order) {
+            int w = instance.item_weight[itemIdx];
+            if (currentWeight + w > instance.capacity) continue;
+            
+            double dist = remaining[instance.item_node[itemIdx]];
+            double extraTime = dist / velocity(currentWeight + w) - dist / velocity(currentWeight);
+            if (instance.item_profit[itemIdx] > extraTime * instance.renting_ratio) {
+                pickingPlan.set(itemIdx);
+                currentWeight += w;
+            }
+        }
     }
 };
 
 class HillClimbingPicking : public TTPHeuristic {
 private:
+    static const int BATCH_FLIPS = 8;
+    
     bool improvePicking(TTPSolution& sol) {
+        PhaseTimer timer(counters, PHASE_PACKING);
         bool improved = false;
         
-        for (int i = 0; i < instance.num_items; i++) {
-            sol.pickingPlan[i] = 1 - sol.pickingPlan[i];
-            
-            double oldObj = sol.objective;
-            evaluateSolution(sol);
+        PickingDeltaEvaluator& delta = work.picking;
+        delta.reset(sol.tour, sol.pickingPlan);
+        
+        // Primera mejora en lotes: se juntan los siguientes items que pasan
+        // la cota, se evalúan todos a la vez con flipDeltaBatch y se aplica
+        // el primero que mejora; los que venían detrás se vuelven a evaluar
+        // contra el plan nuevo. Mismo resultado que de a uno.
+        vector<int>& batch = work.batchItems;
+        double gains[BATCH_FLIPS];
+        int next = 0;
+        while (next < instance.num_items && !timeUp()) {
+            batch.clear();
+            for (; next < instance.num_items && (int)batch.size() < BATCH_FLIPS; next++) {
+                if (delta.flipUpperBound(sol.pickingPlan, next) > 1e-9) batch.push_back(next);
+            }
+            if (batch.empty()) break;
             
-            if (sol.isValid(instance) && sol.objective > oldObj) {
-                improved = true;
-            } else {
-                sol.pickingPlan[i] = 1 - sol.pickingPlan[i];
-                evaluateSolution(sol);
+            delta.flipDeltaBatch(sol.pickingPlan, batch.data(), batch.size(), gains);
+            counters.tried[OP_FLIP] += batch.size();
+            for (size_t b = 0; b < batch.size(); b++) {
+                if (gains[b] > 1e-9) {
+                    delta.applyFlip(sol.pickingPlan, batch[b]);
+                    counters.accepted[OP_FLIP]++;
+                    improved = true;
+                    next = batch[b] + 1;
+                    break;
+                }
             }
         }
+        
+        evaluateSolution(sol);
         return improved;
     }
+    
+    // plan inicial: el voraz por ratio o el que descarta los items cuyo
+    // alquiler extra supera su ganancia (fillTourAwarePickingPlan), el que
+    // tenga mejor objetivo
+    void startingPlan(TTPSolution& sol) {
+        fillGreedyPickingPlan(sol.tour, sol.pickingPlan);
+        evaluateSolution(sol);
+        
+        TTPSolution aware;
+        aware.tour = sol.tour;
+        fillTourAwarePickingPlan(aware.tour, aware.pickingPlan);
+        evaluateSolution(aware);
+        if (aware.objective > sol.objective) {
+            sol = move(aware);
+        }
+    }
 
 public:
     HillClimbingPicking(const TTPInstance& inst) : TTPHeuristic(inst) {}
     
+    TTPHeuristic* clone() const override {
+        return new HillClimbingPicking(*this);
+    }
+    
     string getName() const override {
         return "Nearest Neighbor Tour + Hill Climbing Picking";
     }
     
     TTPSolution solve() override {
         TTPSolution sol;
-        sol.tour = createNearestNeighborTour(0);
-        sol.pickingPlan = createGreedyPickingPlan(sol.tour);
+        if (!initialTour(sol, [&] { return createNearestNeighborTour(0); })) {
+            startingPlan(sol);
+        }
         evaluateSolution(sol);
+        recordBest(sol);
         
         int iterations = 0;
-        while (improvePicking(sol) && iterations < 100) {
+        while (improvePicking(sol) && keepIterating(iterations, 100)) {
             iterations++;
+            recordBest(sol);
         }
+        recordBest(sol);
         
         return sol;
     }
@@ -195,6 +568,15 @@ public:
 // ESTADÍSTICAS Y EXPERIMENTOS CON MÚLTIPLES EJECUCIONES
 // ============================================================
 
+// medición de una ejecución (heurística, run)
+struct RunMetrics {
+    double wall_seconds;       // duración de solve()
+    long peak_rss_kb;          // pico de memoria de la ejecución (ver TTPExperiment::rss_per_run)
+    SearchCounters counters;
+    
+    RunMetrics() : wall_seconds(0), peak_rss_kb(0) {}
+};
+
 struct HeuristicStats {
     string name;
     double avg_objective;
@@ -204,10 +586,15 @@ struct HeuristicStats {
     double best_objective;
     double worst_objective;
     double std_dev_objective;
+    double avg_wall_seconds;
+    long peak_rss_kb;
+    SearchCounters counters;      // suma de todas las ejecuciones
+    vector<uint64_t> run_seeds;   // semilla de cada ejecución, para reproducirla
     
     HeuristicStats() : avg_objective(0), avg_profit(0), avg_time(0), 
                        avg_weight(0), best_objective(-1e9), 
-                       worst_objective(1e9), std_dev_objective(0) {}
+                       worst_objective(1e9), std_dev_objective(0),
+                       avg_wall_seconds(0), peak_rss_kb(0) {}
 };
 
 class TTPExperiment {
@@ -215,6 +602,24 @@ private:
     const TTPInstance& instance;
     vector<TTPHeuristic*> heuristics;
     int num_runs;
+    int num_threads;
+    int search_threads;                                  // hilos dentro de cada ejecución
+    int num_islands;                                     // islas de LNS/VNS por ejecución
+    uint64_t master_seed;
+    double time_limit;                                   // segundos por ejecución (0 = sin límite)
+    string trajectory_file;                              // CSV con la trayectoria de cada ejecución
+    string stats_file;                                   // CSV o JSON con las mediciones de cada ejecución
+    vector<vector<pair<double, double>>> trajectories;   // por trabajo (heurística, run)
+    vector<RunMetrics> metrics;                          // por trabajo (heurística, run)
+    // Con un solo hilo el pico de memoria del proceso se reinicia antes de
+    // cada ejecución y peak_rss_kb es el pico de esa ejecución (incluye la
+    // instancia cargada). Con varios hilos las ejecuciones comparten el
+    // proceso: peak_rss_kb es solo cuánto subió el pico del proceso mientras
+    // corría (0 si otra ejecución ya lo había llevado más arriba).
+    bool rss_per_run;
+    string solution_dir;                                 // directorio con la solución de cada ejecución
+    string instance_label;                               // nombre de la instancia en esos archivos
+    ResultSink sink;
     
     double calculateStdDev(const vector<double>& values, double mean) {
         double sum = 0.0;
@@ -224,9 +629,32 @@ private:
         return sqrt(sum / values.size());
     }
     
+    // contadores promediados por ejecución
+    void printCounters(const HeuristicStats& stats) {
+        const SearchCounters& c = stats.counters;
+        cout << "    Evaluaciones: " << c.evaluations / num_runs << endl;
+        cout << "    Movimientos probados/aceptados:";
+        for (int op = 0; op < NUM_OPERATORS; op++) {
+            cout << " " << operatorName(op) << " " << c.tried[op] / num_runs
+                 << "/" << c.accepted[op] / num_runs;
+        }
+        cout << endl;
+        cout << "    Tiempo por fase:";
+        for (int phase = 0; phase < NUM_PHASES; phase++) {
+            cout << (phase ? ", " : " ") << phaseName(phase) << " " << c.seconds[phase] / num_runs << " s";
+        }
+        cout << endl;
+        if (rss_per_run) {
+            cout << "    Memoria maxima por ejecucion: " << stats.peak_rss_kb / 1024 << " MB" << endl;
+        } else {
+            cout << "    Aumento del pico de memoria del proceso: " << stats.peak_rss_kb / 1024 << " MB" << endl;
+        }
+    }
+    
 public:
     TTPExperiment(const TTPInstance& inst, int runs = 1) 
-        : instance(inst), num_runs(runs) {}
+        : instance(inst), num_runs(runs), num_threads(1), search_threads(1), num_islands(1),
+          master_seed(time(0)), time_limit(0), rss_per_run(false) {}
     
     ~TTPExperiment() {
         for (auto h : heuristics) {
@@ -238,6 +666,175 @@ public:
         heuristics.push_back(heuristic);
     }
     
+    void setThreads(int threads) {
+        num_threads = max(1, threads);
+    }
+    
+    void setSearchThreads(int threads) {
+        search_threads = max(1, threads);
+    }
+    
+    void setIslands(int count) {
+        num_islands = max(1, count);
+    }
+    
+    void setSeed(uint64_t seed) {
+        master_seed = seed;
+    }
+    
+    void setTimeLimit(double seconds) {
+        time_limit = max(0.0, seconds);
+    }
+    
+    void setTrajectoryFile(const string& filename) {
+        trajectory_file = filename;
+    }
+    
+    // formato según la extensión: .json o, si no, CSV
+    void setStatsFile(const string& filename) {
+        stats_file = filename;
+    }
+    
+    // escribir la solución de cada ejecución en dir (ttp_sink.h) a medida
+    // que terminan; label identifica la instancia en los nombres de archivo
+    bool setSolutionDir(const string& dir, const string& label) {
+        solution_dir = dir;
+        instance_label = label;
+        return sink.open(dir);
+    }
+    
+    // semilla del trabajo 'job' = (heurística job / num_runs, run job % num_runs)
+    uint64_t jobSeed(int job) const {
+        return deriveSeed(master_seed, job / num_runs, job % num_runs);
+    }
+    
+    // Ejecuta todos los pares (heurística, run) en el pool de hilos. Cada
+    // trabajo usa su propia copia de la heurística con la semilla derivada de
+    // la semilla maestra; el resultado queda en su casilla, así el resumen
+    // no depende del orden en que terminen los hilos.
+    vector<TTPSolution> runJobs() {
+        int numJobs = heuristics.size() * num_runs;
+        vector<TTPSolution> results(numJobs);
+        trajectories.assign(numJobs, {});
+        metrics.assign(numJobs, RunMetrics());
+        rss_per_run = num_threads == 1 && resetPeakResident();
+        
+        ThreadPool pool(num_threads);
+        pool.parallelFor(numJobs, [&](int job) {
+            unique_ptr<TTPHeuristic> worker(heuristics[job / num_runs]->clone());
+            worker->setSeed(jobSeed(job));
+            worker->setSearchThreads(search_threads);
+            worker->setIslands(num_islands);
+            long peakBefore = 0;
+            if (rss_per_run) {
+                resetPeakResident();
+            } else {
+                peakBefore = peakResidentKB();
+            }
+            worker->startClock(time_limit);
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            results[job] = worker->solve();
+            metrics[job].wall_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            metrics[job].peak_rss_kb = peakResidentKB() - peakBefore;
+            metrics[job].counters = worker->getCounters();
+            trajectories[job] = worker->getTrajectory();
+            if (sink.isOpen()) {
+                sink.submit({instance_label, worker->getName(), job % num_runs + 1, jobSeed(job), results[job]});
+            }
+        });
+        
+        return results;
+    }
+    
+    // una fila por mejora: heurística, run, semilla, segundos, objetivo
+    bool writeTrajectories(const string& filename) {
+        ofstream out(filename);
+        if (!out) {
+            cerr << "Error: No se pudo escribir la trayectoria en " << filename << endl;
+            return false;
+        }
+        out << "heuristica,run,semilla,segundos,objetivo" << endl;
+        out.precision(10);
+        for (size_t job = 0; job < trajectories.size(); job++) {
+            for (auto& point : trajectories[job]) {
+                out << "\"" << heuristics[job / num_runs]->getName() << "\","
+                    << (job % num_runs + 1) << "," << jobSeed(job) << ","
+                    << point.first << "," << point.second << endl;
+            }
+        }
+        return true;
+    }
+    
+    // nombre de la columna de memoria según lo que mide peak_rss_kb
+    const char* rssColumn() const {
+        return rss_per_run ? "rss_pico_kb" : "rss_aumento_pico_kb";
+    }
+    
+    // una fila por ejecución: resultado, tiempo de pared, memoria y contadores
+    bool writeStatsCSV(const string& filename, const vector<TTPSolution>& results) {
+        ofstream out(filename);
+        if (!out) {
+            cerr << "Error: No se pudo escribir las estadisticas en " << filename << endl;
+            return false;
+        }
+        out << "heuristica,run,semilla,objetivo,segundos," << rssColumn() << ",evaluaciones";
+        for (int op = 0; op < NUM_OPERATORS; op++) {
+            out << ",probados_" << operatorName(op) << ",aceptados_" << operatorName(op);
+        }
+        for (int phase = 0; phase < NUM_PHASES; phase++) out << ",segundos_" << phaseName(phase);
+        out << endl;
+        
+        out.precision(10);
+        for (size_t job = 0; job < metrics.size(); job++) {
+            const RunMetrics& m = metrics[job];
+            out << "\"" << heuristics[job / num_runs]->getName() << "\","
+                << (job % num_runs + 1) << "," << jobSeed(job) << ","
+                << results[job].objective << "," << m.wall_seconds << ","
+                << m.peak_rss_kb << "," << m.counters.evaluations;
+            for (int op = 0; op < NUM_OPERATORS; op++) {
+                out << "," << m.counters.tried[op] << "," << m.counters.accepted[op];
+            }
+            for (int phase = 0; phase < NUM_PHASES; phase++) out << "," << m.counters.seconds[phase];
+            out << endl;
+        }
+        return true;
+    }
+    
+    // lo mismo que writeStatsCSV como {"instancia": ..., "ejecuciones": [...]}
+    bool writeStatsJSON(const string& filename, const vector<TTPSolution>& results) {
+        ofstream out(filename);
+        if (!out) {
+            cerr << "Error: No se pudo escribir las estadisticas en " << filename << endl;
+            return false;
+        }
+        out.precision(10);
+        out << "{\n  \"instancia\": \"" << instance.name << "\",\n  \"ejecuciones\": [";
+        for (size_t job = 0; job < metrics.size(); job++) {
+            const RunMetrics& m = metrics[job];
+            out << (job ? ",\n" : "\n") << "    {\"heuristica\": \"" << heuristics[job / num_runs]->getName()
+                << "\", \"run\": " << (job % num_runs + 1) << ", \"semilla\": " << jobSeed(job)
+                << ", \"objetivo\": " << results[job].objective
+                << ", \"segundos\": " << m.wall_seconds << ", \"" << rssColumn() << "\": " << m.peak_rss_kb
+                << ", \"evaluaciones\": " << m.counters.evaluations << ",\n     \"movimientos\": {";
+            for (int op = 0; op < NUM_OPERATORS; op++) {
+                out << (op ? ", " : "") << "\"" << operatorName(op) << "\": {\"probados\": "
+                    << m.counters.tried[op] << ", \"aceptados\": " << m.counters.accepted[op] << "}";
+            }
+            out << "},\n     \"segundos_fase\": {";
+            for (int phase = 0; phase < NUM_PHASES; phase++) {
+                out << (phase ? ", " : "") << "\"" << phaseName(phase) << "\": " << m.counters.seconds[phase];
+            }
+            out << "}}";
+        }
+        out << "\n  ]\n}" << endl;
+        return true;
+    }
+    
+    bool writeStats(const string& filename, const vector<TTPSolution>& results) {
+        bool json = filename.size() >= 5 && filename.compare(filename.size() - 5, 5, ".json") == 0;
+        return json ? writeStatsJSON(filename, results) : writeStatsCSV(filename, results);
+    }
+    
     void runAll() {
         cout << "\n---------------------------------------" << endl;
         cout << "       EXPERIMENTO TTP" << endl;
@@ -246,13 +843,34 @@ public:
         cout << "Items: " << instance.num_items << endl;
         cout << "Capacidad: " << instance.capacity << endl;
         cout << "Ejecuciones por heuristica: " << num_runs << endl;
+        cout << "Hilos: " << num_threads << endl;
+        if (search_threads > 1) {
+            cout << "Hilos por ejecucion: " << search_threads << endl;
+        }
+        if (num_islands > 1) {
+            cout << "Islas por ejecucion (LNS/VNS): " << num_islands << endl;
+        }
+        cout << "Semilla maestra: " << master_seed << endl;
+        if (time_limit > 0) {
+            cout << "Limite de tiempo por ejecucion: " << time_limit << " s" << endl;
+        }
         cout << "-----------------------------------------\n" << endl;
         
+        vector<TTPSolution> results = runJobs();
+        if (!trajectory_file.empty()) {
+            writeTrajectories(trajectory_file);
+        }
+        if (!stats_file.empty()) {
+            writeStats(stats_file, results);
+        }
+        
         vector<HeuristicStats> allStats;
         TTPSolution globalBest;
         string globalBestHeuristic;
+        uint64_t globalBestSeed = 0;
         
-        for (auto heuristic : heuristics) {
+        for (size_t h = 0; h < heuristics.size(); h++) {
+            TTPHeuristic* heuristic = heuristics[h];
             cout << ">>> Ejecutando: " << heuristic->getName() << " <<<" << endl;
             
             HeuristicStats stats;
@@ -268,7 +886,13 @@ public:
                     cout << "  [Run " << run << "/" << num_runs << "] ";
                 }
                 
-                TTPSolution solution = heuristic->solve();
+                const TTPSolution& solution = results[h * num_runs + run - 1];
+                const RunMetrics& runMetrics = metrics[h * num_runs + run - 1];
+                uint64_t seed = jobSeed(h * num_runs + run - 1);
+                stats.run_seeds.push_back(seed);
+                stats.avg_wall_seconds += runMetrics.wall_seconds;
+                stats.peak_rss_kb = max(stats.peak_rss_kb, runMetrics.peak_rss_kb);
+                stats.counters.add(runMetrics.counters);
                 
                 objectives.push_back(solution.objective);
                 profits.push_back(solution.profit);
@@ -276,12 +900,19 @@ public:
                 weights.push_back(solution.weight);
                 
                 if (num_runs > 1) {
-                    cout << "Objetivo: " << solution.objective << endl;
+                    cout << "Objetivo: " << solution.objective 
+                         << " (semilla " << seed << ")";
+                    const auto& trajectory = trajectories[h * num_runs + run - 1];
+                    if (time_limit > 0 && !trajectory.empty()) {
+                        cout << " [mejor a los " << trajectory.back().first << " s]";
+                    }
+                    cout << endl;
                 }
                 
                 if (solution.objective > globalBest.objective) {
                     globalBest = solution;
                     globalBestHeuristic = heuristic->getName();
+                    globalBestSeed = seed;
                 }
                 
                 if (solution.objective > stats.best_objective) {
@@ -302,6 +933,7 @@ public:
             stats.avg_profit /= num_runs;
             stats.avg_time /= num_runs;
             stats.avg_weight /= num_runs;
+            stats.avg_wall_seconds /= num_runs;
             
             if (num_runs > 1) {
                 stats.std_dev_objective = calculateStdDev(objectives, stats.avg_objective);  //desviación estándar del objetivo
@@ -319,13 +951,17 @@ public:
                 cout << "    Tiempo Promedio: " << stats.avg_time << endl;
                 cout << "    Peso Promedio: " << stats.avg_weight 
                      << "/" << instance.capacity << endl;
+                cout << "    Duracion Promedio: " << stats.avg_wall_seconds << " s" << endl;
+                cout << "  POR EJECUCION (promedio):" << endl;
             } else {
                 cout << "    Objetivo: " << stats.avg_objective << endl;
                 cout << "    Ganancia: " << stats.avg_profit << endl;
                 cout << "    Tiempo: " << stats.avg_time << endl;
                 cout << "    Peso: " << stats.avg_weight 
                      << "/" << instance.capacity << endl;
+                cout << "    Duracion: " << stats.avg_wall_seconds << " s" << endl;
             }
+            printCounters(stats);
             cout << endl;
         }
         
@@ -343,17 +979,22 @@ public:
             if (num_runs > 1) {
                 cout << " (±" << allStats[i].std_dev_objective << ")";
             }
-            cout << endl;
+            cout << "  [" << allStats[i].avg_wall_seconds << " s]" << endl;
         }
         
         cout << "\n========================================" << endl;
         cout << "MEJOR SOLUCION GLOBAL:" << endl;
         cout << "Heuristica: " << globalBestHeuristic << endl;
+        cout << "Semilla: " << globalBestSeed << endl;
         cout << "Objetivo: " << globalBest.objective << endl;
         cout << "Ganancia: " << globalBest.profit << endl;
         cout << "Tiempo: " << globalBest.time << endl;
         cout << "Peso: " << globalBest.weight << "/" << instance.capacity << endl;
         cout << "========================================\n" << endl;
+        
+        if (!solution_dir.empty() && sink.close()) {
+            cout << "Soluciones guardadas en " << solution_dir << endl;
+        }
     }
 };
 
@@ -0,0 +1,79 @@
+// Cuenta las reservas de memoria del bucle principal de BalancedLNS y
+// BalancedVNS. Se resuelve la misma instancia con la misma semilla con N y
+// 2N iteraciones: las primeras N iteraciones son idénticas, así que la
+// diferencia de reservas entre ambas corridas es lo que piden las N
+// iteraciones extra (en régimen estacionario debería ser ~0).
+//
+// Compilar desde la raíz del repositorio:
+//   g++ -O2 -I. bench/alloc_lns.cpp -o alloc_lns
+// Uso:
+//   ./alloc_lns <archivo_ttp> [iteraciones]
+
+#include "ttp_cache.h"
+#include "ttp_heuristics.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static atomic<long> allocations(0);
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+// noinline: si no, g++ ve el free() y avisa de un new/delete "mezclado"
+__attribute__((noinline)) void operator delete(void* p) noexcept { free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { free(p); }
+
+// reservas hechas por una corrida de la heurística con la semilla dada
+long countAllocations(TTPHeuristic& heuristic, uint64_t seed, double& objective) {
+    heuristic.setSeed(seed);
+    heuristic.startClock(0);
+    long before = allocations.load();
+    TTPSolution sol = heuristic.solve();
+    long after = allocations.load();
+    objective = sol.objective;
+    return after - before;
+}
+
+template <typename Heuristic>
+void report(const TTPInstance& instance, const string& label, int iterations, int extra) {
+    Heuristic shortRun = Heuristic(instance, extra, iterations);
+    Heuristic longRun = Heuristic(instance, extra, 2 * iterations);
+
+    double objShort, objLong;
+    long allocShort = countAllocations(shortRun, 12345, objShort);
+    long allocLong = countAllocations(longRun, 12345, objLong);
+
+    cout << label << endl;
+    cout << "  " << iterations << " iteraciones: " << allocShort << " reservas (objetivo " << objShort << ")" << endl;
+    cout << "  " << 2 * iterations << " iteraciones: " << allocLong << " reservas (objetivo " << objLong << ")" << endl;
+    cout << "  reservas por iteracion extra: "
+         << (double)(allocLong - allocShort) / iterations << endl;
+}
+
+// BalancedVNS recibe (maxIter, kmax) en lugar de (k, maxIter)
+struct VNSAdapter : BalancedVNS {
+    VNSAdapter(const TTPInstance& inst, int kmax, int maxIter) : BalancedVNS(inst, maxIter, kmax) {}
+};
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "Uso: " << argv[0] << " <archivo_ttp> [iteraciones]" << endl;
+        return 1;
+    }
+    int iterations = argc >= 3 ? atoi(argv[2]) : 20;
+
+    TTPInstance instance;
+    if (!loadInstance(argv[1], instance, "")) {
+        return 1;
+    }
+    cout << "Instancia: " << instance.name << " (" << instance.dimension
+         << " ciudades, " << instance.num_items << " items)" << endl;
+
+    report<BalancedLNS>(instance, "Balanced LNS (destroy=10)", iterations, 10);
+    report<VNSAdapter>(instance, "Balanced VNS (kmax=5)", iterations, 5);
+    return 0;
+}
@@ -0,0 +1,313 @@
+// Micro-benchmarks de los núcleos del simulador: evaluación, construcción
+// del tour y del picking, y un barrido de cada búsqueda local. Sirve para
+// medir cada optimización y detectar regresiones comparando el CSV de dos
+// versiones.
+//
+// Sin archivos se usa un conjunto representativo de Instances/ (eil76,
+// a280, rl1304 y fnl4461 en cada densidad de items, tipo Uncorrelated).
+//
+// Compilar desde la raíz del repositorio:
+//   g++ -O2 -I. bench/micro.cpp -o micro -pthread
+// Uso:
+//   ./micro [archivos_ttp...] [--filter texto] [--min-time segundos]
+//           [--csv archivo] [--no-cache]
+
+#include "ttp_cache.h"
+#include "ttp_heuristics.h"
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+
+// ============================================================
+// ARNÉS DE MEDICIÓN
+// ============================================================
+// run(): la operación se repite en lotes; el lote se duplica hasta durar al
+// menos minSeconds / SAMPLES y después se miden SAMPLES lotes de ese
+// tamaño. Se informa la mediana del tiempo por operación, que sufre menos
+// que la media cuando el sistema interrumpe una medición.
+// runWithSetup(): para operaciones que modifican su entrada (barridos de
+// búsqueda local). setup() restaura el estado fuera de la medición y cada
+// llamada se mide sola, hasta juntar minSeconds o MAX_REPS llamadas.
+// Las operaciones devuelven un double que se acumula en 'sink' para que el
+// compilador no pueda descartarlas.
+struct BenchResult {
+    string instance;
+    string name;
+    double nsPerOp;
+    long reps;
+};
+
+class MicroBench {
+private:
+    static const int SAMPLES = 5;
+    static const int MIN_REPS = 3;
+    static const long MAX_REPS = 1000;
+
+    typedef chrono::steady_clock Clock;
+
+    double minSeconds;
+    string filter;
+    string instanceName;
+    vector<BenchResult> results;
+    volatile double sink;
+
+    static double seconds(Clock::time_point from, Clock::time_point to) {
+        return chrono::duration<double>(to - from).count();
+    }
+
+    static double median(vector<double>& values) {
+        sort(values.begin(), values.end());
+        return values[values.size() / 2];
+    }
+
+    bool selected(const string& name) const {
+        return filter.empty() || name.find(filter) != string::npos;
+    }
+
+    void report(const string& name, double nsPerOp, long reps) {
+        const char* unit = "ns";
+        double value = nsPerOp;
+        if (value >= 1e6) { value /= 1e6; unit = "ms"; }
+        else if (value >= 1e3) { value /= 1e3; unit = "us"; }
+
+        cout << "  " << left << setw(44) << name << right << setw(10) << fixed
+             << setprecision(2) << value << " " << unit << "/op  (" << reps << " rep.)" << endl;
+        cout.unsetf(ios::fixed);
+        results.push_back({instanceName, name, nsPerOp, reps});
+    }
+
+public:
+    MicroBench(double minTime, const string& nameFilter)
+        : minSeconds(minTime), filter(nameFilter), sink(0) {}
+
+    void setInstance(const string& name) {
+        instanceName = name;
+    }
+
+    void run(const string& name, const function<double()>& op) {
+        if (!selected(name)) return;
+
+        double target = minSeconds / SAMPLES;
+        long batch = 1;
+        for (;;) {
+            Clock::time_point t0 = Clock::now();
+            for (long r = 0; r < batch; r++) sink = sink + op();
+            if (seconds(t0, Clock::now()) >= target || batch >= (1L << 30)) break;
+            batch *= 2;
+        }
+
+        vector<double> perOp;
+        for (int s = 0; s < SAMPLES; s++) {
+            Clock::time_point t0 = Clock::now();
+            for (long r = 0; r < batch; r++) sink = sink + op();
+            perOp.push_back(seconds(t0, Clock::now()) * 1e9 / batch);
+        }
+        report(name, median(perOp), batch * SAMPLES);
+    }
+
+    void runWithSetup(const string& name, const function<void()>& setup, const function<double()>& op) {
+        if (!selected(name)) return;
+
+        vector<double> perOp;
+        double total = 0;
+        while ((long)perOp.size() < MAX_REPS && (total < minSeconds || (int)perOp.size() < MIN_REPS)) {
+            setup();
+            Clock::time_point t0 = Clock::now();
+            sink = sink + op();
+            double elapsed = seconds(t0, Clock::now());
+            perOp.push_back(elapsed * 1e9);
+            total += elapsed;
+        }
+        report(name, median(perOp), perOp.size());
+    }
+
+    bool writeCSV(const string& filename) const {
+        ofstream out(filename);
+        if (!out) {
+            cerr << "Error: no se pudo crear " << filename << endl;
+            return false;
+        }
+        out << "instancia,benchmark,ns_por_op,repeticiones" << endl;
+        out << setprecision(10);
+        for (const BenchResult& r : results) {
+            out << r.instance << "," << r.name << "," << r.nsPerOp << "," << r.reps << endl;
+        }
+        return true;
+    }
+};
+
+// ============================================================
+// ACCESO A LOS MÉTODOS PROTEGIDOS
+// ============================================================
+// Los constructores de planes y el barrido de picking son protegidos en
+// BalancedTTPHeuristic; esta subclase solo los hace visibles.
+class BenchProbe : public BalancedTTPHeuristic {
+public:
+    BenchProbe(const TTPInstance& inst) : BalancedTTPHeuristic(inst) {}
+
+    using BalancedTTPHeuristic::createAdaptivePickingPlan;
+    using BalancedTTPHeuristic::improvePickingWithObjective;
+
+    TTPSolution solve() override { return TTPSolution(); }
+    string getName() const override { return "Bench"; }
+    TTPHeuristic* clone() const override { return new BenchProbe(*this); }
+};
+
+const char* DEFAULT_INSTANCES[] = {
+    "Instances/eil76 /n75/Uncorrelated/eil76_n75_uncorr_01.ttp",
+    "Instances/eil76 /n225/Uncorrelated/eil76_n225_uncorr_01.ttp",
+    "Instances/eil76 /n375/Uncorrelated/eil76_n375_uncorr_01.ttp",
+    "Instances/eil76 /n750/Uncorrelated/eil76_n750_uncorr_01.ttp",
+    "Instances/a280/n279/Uncorrelated/a280_n279_uncorr_01.ttp",
+    "Instances/a280/n837/Uncorrelated/a280_n837_uncorr_01.ttp",
+    "Instances/a280/n1395/Uncorrelated/a280_n1395_uncorr_01.ttp",
+    "Instances/a280/n2790/Uncorrelated/a280_n2790_uncorr_01.ttp",
+    "Instances/rl1304 /n1303/Uncorrelated/rl1304_n1303_uncorr_01.ttp",
+    "Instances/rl1304 /n3909/Uncorrelated/rl1304_n3909_uncorr_01.ttp",
+    "Instances/rl1304 /n6515/Uncorrelated/rl1304_n6515_uncorr_01.ttp",
+    "Instances/rl1304 /n13030/Uncorrelated/rl1304_n13030_uncorr_01.ttp",
+    "Instances/fnl4461 /n4460/Uncorrelated/fnl4461_n4460_uncorr_01.ttp",
+    "Instances/fnl4461 /n13380/Uncorrelated/fnl4461_n13380_uncorr_01.ttp",
+    "Instances/fnl4461 /n22300/Uncorrelated/fnl4461_n22300_uncorr_01.ttp",
+    "Instances/fnl4461 /n44600/Uncorrelated/fnl4461_n44600_uncorr_01.ttp",
+};
+
+void benchInstance(MicroBench& bench, const TTPInstance& instance) {
+    BenchProbe probe(instance);
+    probe.setSeed(12345);
+    probe.startClock(0);
+
+    // punto de partida común: tour NN y plan greedy
+    TTPSolution start;
+    start.tour = probe.createNearestNeighborTour();
+    start.pickingPlan = probe.createGreedyPickingPlan(start.tour);
+    probe.evaluateSolution(start);
+    TTPSolution sol = start;
+
+    // ---------- evaluación ----------
+    bench.run("evaluateSolution", [&] {
+        probe.evaluateSolution(sol);
+        return sol.objective;
+    });
+
+    // ---------- construcción ----------
+    bench.run("createNearestNeighborTour", [&] {
+        return (double)probe.createNearestNeighborTour()[1];
+    });
+    bench.run("createGreedyPickingPlan", [&] {
+        return (double)probe.createGreedyPickingPlan(start.tour).count();
+    });
+    bench.run("createAdaptivePickingPlan (70%)", [&] {
+        return (double)probe.createAdaptivePickingPlan(start.tour).count();
+    });
+    PickingPlan plan;
+    bench.run("fillTourAwarePickingPlan", [&] {
+        probe.fillTourAwarePickingPlan(start.tour, plan);
+        return (double)plan.count();
+    });
+    // PackIterative: búsqueda completa en los dos sentidos y la corta que
+    // usa packTour cuando el tour casi no cambió (aquí, el mismo tour)
+    PackingPlanner packer(instance);
+    vector<int> packTour;
+    bench.run("PackingPlanner::packBothDirections", [&] {
+        packTour = start.tour;
+        return packer.packBothDirections(packTour, plan);
+    });
+    packTour = start.tour;
+    packer.packTour(packTour, plan);
+    bench.run("PackingPlanner::packTour (mismo tour)", [&] {
+        return packer.packTour(packTour, plan);
+    });
+
+    // ---------- búsqueda local (un barrido desde el punto de partida) ----------
+    bench.runWithSetup("improve2OptLimited (barrido)", [&] { sol = start; }, [&] {
+        probe.improve2OptLimited(sol);
+        return sol.objective;
+    });
+    bench.runWithSetup("improvePickingWithObjective (barrido)", [&] { sol = start; }, [&] {
+        probe.improvePickingWithObjective(sol);
+        return sol.objective;
+    });
+    vector<int> tour;
+    bench.runWithSetup("improveTourLK (sin patadas)", [&] { tour = start.tour; }, [&] {
+        return probe.improveTourLK(tour, 0);
+    });
+
+    // ---------- núcleos por lotes (SIMD) ----------
+    // delta de invertir cada item del plan greedy, uno a uno y en lotes
+    PickingDeltaEvaluator delta(instance);
+    delta.reset(start.tour, start.pickingPlan);
+    vector<int> items(instance.num_items);
+    for (int i = 0; i < instance.num_items; i++) items[i] = i;
+    vector<double> deltas(instance.num_items);
+
+    bench.run("flipDeltaFast (todos los items)", [&] {
+        double acc = 0;
+        for (int i = 0; i < instance.num_items; i++) acc += delta.flipDeltaFast(start.pickingPlan, i);
+        return acc;
+    });
+    bench.run("flipDeltaBatch (todos los items)", [&] {
+        delta.flipDeltaBatch(start.pickingPlan, items.data(), instance.num_items, deltas.data());
+        return deltas[0];
+    });
+}
+
+int main(int argc, char* argv[]) {
+    vector<string> files;
+    string filter;
+    string csvFile;
+    string cacheDir = ".ttp_cache";
+    double minTime = 0.2;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            minTime = atof(argv[++i]);
+            if (minTime <= 0) {
+                cerr << "Error: --min-time debe ser > 0" << endl;
+                return 1;
+            }
+        } else if (arg == "--csv" && i + 1 < argc) {
+            csvFile = argv[++i];
+        } else if (arg == "--no-cache") {
+            cacheDir = "";
+        } else if (arg.rfind("--", 0) == 0) {
+            cerr << "Uso: " << argv[0] << " [archivos_ttp...] [--filter texto] [--min-time segundos]"
+                 << " [--csv archivo] [--no-cache]" << endl;
+            return 1;
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()) {
+        files.assign(begin(DEFAULT_INSTANCES), end(DEFAULT_INSTANCES));
+    }
+
+    cout << "SIMD: " << simdLevelName(activeSimdLevel()) << endl;
+    cout << "Tiempo minimo por benchmark: " << minTime << " s" << endl;
+
+    MicroBench bench(minTime, filter);
+    for (const string& file : files) {
+        TTPInstance instance;
+        if (!loadInstance(file, instance, cacheDir)) {
+            return 1;
+        }
+        // el nombre del problema es el mismo en todas las densidades; se
+        // identifica cada caso por el nombre del archivo
+        string label = file.substr(file.find_last_of('/') + 1);
+        if (label.size() > 4 && label.compare(label.size() - 4, 4, ".ttp") == 0) {
+            label.resize(label.size() - 4);
+        }
+        cout << endl << label << " (" << instance.dimension << " ciudades, "
+             << instance.num_items << " items)" << endl;
+        bench.setInstance(label);
+        benchInstance(bench, instance);
+    }
+
+    if (!csvFile.empty() && !bench.writeCSV(csvFile)) {
+        return 1;
+    }
+    return 0;
+}
@@ -1,23 +1,197 @@
 #include "reader.cpp"
+#include "ttp_cache.h"
 #include "base1.h"
 #include "ttp_heuristics.h"
+#include "ttp_sweep.h"
+
+// heurísticas de cada experimento (y de cada instancia del modo --batch)
+vector<HeuristicFactory> experimentHeuristics() {
+    vector<HeuristicFactory> heuristics;
+    
+    // heuristics.push_back(makeFactory<LocalSearch2Opt>());
+    
+    // heuristics.push_back(makeFactory<ProbabilisticNearestNeighbor2Opt>(0.3));
+    // heuristics.push_back(makeFactory<ProbabilisticNearestNeighbor2Opt>(0.5));
+    // heuristics.push_back(makeFactory<ProbabilisticNearestNeighbor2Opt>(1.0));
+    // heuristics.push_back(makeFactory<ProbabilisticNearestNeighbor2Opt>(2.0));
+
+    // heuristics.push_back(makeFactory<SequentialNoItems>());
+    // heuristics.push_back(makeFactory<NearestNeighborGreedy>());
+    // heuristics.push_back(makeFactory<RandomTourGreedy>());
+    // heuristics.push_back(makeFactory<HighProfitPicking>());
+    
+    heuristics.push_back(makeFactory<HillClimbingPicking>());
+    
+    heuristics.push_back(makeFactory<ImprovedHillClimbing>());
+    heuristics.push_back(makeFactory<Balanced2Opt>());
+    
+    heuristics.push_back(makeFactory<BalancedLNS>(10, 20));
+    heuristics.push_back(makeFactory<BalancedLNS>(15, 30));
+    heuristics.push_back(makeFactory<BalancedLNS>(20, 40));
+    
+    heuristics.push_back(makeFactory<LinKernighanPacking>());
+    
+/* 
+    heuristics.push_back(makeFactory<BalancedVNS>(30, 3));
+    heuristics.push_back(makeFactory<BalancedVNS>(50, 5));
+    heuristics.push_back(makeFactory<BalancedVNS>(80, 7));
+*/
+    
+    return heuristics;
+}
 
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        cerr << "Uso: " << argv[0] << " <archivo_ttp> [num_ejecuciones]" << endl;
-        cerr << "  num_ejecuciones: numero de veces a ejecutar cada heuristica (default: 5)" << endl;
+    // separar opciones (--xxx valor) de los argumentos posicionales
+    vector<string> positional;
+    size_t distCacheEntries = 0;
+    int num_threads = 1;
+    int search_threads = 1;
+    int islands = 1;
+    bool hasSeed = false;
+    uint64_t seed = 0;
+    string cacheDir = ".ttp_cache";
+    double timeLimit = 0;
+    string trajectoryFile;
+    string statsFile;
+    string batchSource;
+    string batchOutput = "resultados_batch.csv";
+    uint64_t memoryCapMB = 0;
+    string solutionDir;
+    string warmStartPath;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--dist-cache" && i + 1 < argc) {
+            distCacheEntries = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            cacheDir = argv[++i];
+        } else if (arg == "--no-cache") {
+            cacheDir = "";
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = strtoull(argv[++i], nullptr, 10);
+            hasSeed = true;
+        } else if (arg == "--time-limit" && i + 1 < argc) {
+            timeLimit = atof(argv[++i]);
+            if (timeLimit <= 0) {
+                cerr << "Error: --time-limit debe ser > 0" << endl;
+                return 1;
+            }
+        } else if (arg == "--trajectory" && i + 1 < argc) {
+            trajectoryFile = argv[++i];
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batchSource = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            batchOutput = argv[++i];
+        } else if (arg == "--memory-cap" && i + 1 < argc) {
+            memoryCapMB = strtoull(argv[++i], nullptr, 10);
+            if (memoryCapMB == 0) {
+                cerr << "Error: --memory-cap debe ser > 0" << endl;
+                return 1;
+            }
+        } else if (arg == "--warm-start" && i + 1 < argc) {
+            warmStartPath = argv[++i];
+        } else if (arg == "--solutions" && i + 1 < argc) {
+            solutionDir = argv[++i];
+        } else if (arg == "--stats" && i + 1 < argc) {
+            statsFile = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            num_threads = atoi(argv[++i]);
+            if (num_threads < 1) {
+                cerr << "Error: --threads debe ser >= 1" << endl;
+                return 1;
+            }
+        } else if (arg == "--islands" && i + 1 < argc) {
+            islands = atoi(argv[++i]);
+            if (islands < 1) {
+                cerr << "Error: --islands debe ser >= 1" << endl;
+                return 1;
+            }
+        } else if (arg == "--search-threads" && i + 1 < argc) {
+            search_threads = atoi(argv[++i]);
+            if (search_threads < 1) {
+                cerr << "Error: --search-threads debe ser >= 1" << endl;
+                return 1;
+            }
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    
+    // modo barrido: las instancias salen de --batch y el único argumento
+    // posicional es el número de ejecuciones
+    if (!batchSource.empty()) {
+        // el CSV de --output ya trae duración y evaluaciones por ejecución
+        if (!statsFile.empty() || !trajectoryFile.empty()) {
+            cerr << "Error: --stats y --trajectory no se pueden usar con --batch" << endl;
+            return 1;
+        }
+        int num_runs = 1;
+        if (!positional.empty()) {
+            num_runs = atoi(positional[0].c_str());
+            if (num_runs < 1) {
+                cerr << "Error: num_ejecuciones debe ser >= 1" << endl;
+                return 1;
+            }
+        }
+        
+        vector<string> files;
+        if (!collectInstances(batchSource, files)) {
+            return 1;
+        }
+        
+        TTPSweep sweep(files, experimentHeuristics(), num_runs);
+        sweep.setThreads(num_threads);
+        sweep.setSearchThreads(search_threads);
+        sweep.setIslands(islands);
+        if (hasSeed) {
+            sweep.setSeed(seed);
+        }
+        sweep.setTimeLimit(timeLimit);
+        if (memoryCapMB > 0) {
+            sweep.setMemoryCapMB(memoryCapMB);
+        }
+        sweep.setCacheDir(cacheDir);
+        sweep.setDistCache(distCacheEntries);
+        if (!solutionDir.empty() && !sweep.setSolutionDir(solutionDir)) {
+            return 1;
+        }
+        if (!warmStartPath.empty() && !sweep.setWarmStart(warmStartPath)) {
+            return 1;
+        }
+        return sweep.run(batchOutput) ? 0 : 1;
+    }
+    
+    if (positional.empty()) {
+        cerr << "Uso: " << argv[0] << " <archivo_ttp> [num_ejecuciones] [opciones]" << endl;
+        cerr << "     " << argv[0] << " --batch <directorio|patron|manifiesto> [num_ejecuciones] [opciones]" << endl;
+        cerr << "  num_ejecuciones: numero de veces a ejecutar cada heuristica (default: 2)" << endl;
+        cerr << "  --dist-cache N: cache de distancias con a lo sumo N entradas (default: sin cache)" << endl;
+        cerr << "  --threads N: ejecutar las corridas (heuristica, run) en N hilos (default: 1)" << endl;
+        cerr << "  --search-threads N: hilos dentro de cada corrida para los barridos de picking (default: 1)" << endl;
+        cerr << "  --islands N: LNS y VNS corren N trayectorias en paralelo que intercambian su mejor solucion (default: 1)" << endl;
+        cerr << "  --cache-dir D: directorio de la cache binaria de instancias (default: .ttp_cache)" << endl;
+        cerr << "  --no-cache: leer siempre el .ttp sin usar ni escribir la cache" << endl;
+        cerr << "  --time-limit T: cada ejecucion busca durante T segundos y devuelve la mejor solucion (default: iteraciones fijas)" << endl;
+        cerr << "  --trajectory F: guardar en F (CSV) el mejor objetivo de cada ejecucion a lo largo del tiempo (no con --batch)" << endl;
+        cerr << "  --stats F: guardar en F (CSV, o JSON si termina en .json) duracion, memoria, evaluaciones, movimientos y tiempo por fase de cada ejecucion (no con --batch)" << endl;
+        cerr << "  --batch B: correr todas las instancias de B (directorio, patron como 'Instances/*/n*/*/*.ttp' o manifiesto con una ruta por linea; sirve 'trt') en un solo proceso (num_ejecuciones default: 1)" << endl;
+        cerr << "  --output F: CSV con una fila por ejecucion del modo --batch (default: resultados_batch.csv)" << endl;
+        cerr << "  --memory-cap MB: en --batch, no cargar instancias a la vez por encima de MB estimados (default: sin tope)" << endl;
+        cerr << "  --solutions D: guardar en D la solucion de cada ejecucion (formato de la competencia TTP, un .txt por ejecucion, y todas en solutions.bin)" << endl;
+        cerr << "  --warm-start P: empezar desde la solucion o el tour del archivo P, o desde la mejor de la instancia en el directorio P de --solutions (con --batch, solo un directorio; HC, LNS y VNS)" << endl;
+        cerr << "  --seed S: semilla maestra; repite exactamente las mismas corridas (default: hora actual)" << endl;
         return 1;
     }
     
     TTPInstance instance;
-    if (!readTTPFile(argv[1], instance)) {
+    if (!loadInstance(positional[0], instance, cacheDir)) {
         return 1;
     }
+    instance.distances.enableCache(distCacheEntries);
     
-    // Obtener número de ejecuciones (default: 5)
+    // Obtener número de ejecuciones (default: 2)
     int num_runs = 2;
-    if (argc >= 3) {
-        num_runs = atoi(argv[2]);
+    if (positional.size() >= 2) {
+        num_runs = atoi(positional[1].c_str());
         if (num_runs < 1) {
             cerr << "Error: num_ejecuciones debe ser >= 1" << endl;
             return 1;
@@ -30,33 +204,44 @@ int main(int argc, char* argv[]) {
     cout << "Numero de ejecuciones por heuristica: " << num_runs << endl;
   
     TTPExperiment experiment(instance, num_runs);
+    experiment.setThreads(num_threads);
+    experiment.setSearchThreads(search_threads);
+    experiment.setIslands(islands);
+    if (hasSeed) {
+        experiment.setSeed(seed);
+    }
+    experiment.setTimeLimit(timeLimit);
+    if (!trajectoryFile.empty()) {
+        experiment.setTrajectoryFile(trajectoryFile);
+    }
+    if (!statsFile.empty()) {
+        experiment.setStatsFile(statsFile);
+    }
+    if (!solutionDir.empty() && !experiment.setSolutionDir(solutionDir, instanceLabel(positional[0]))) {
+        return 1;
+    }
     
-    // experiment.addHeuristic(new LocalSearch2Opt(instance));
-    
-    // experiment.addHeuristic(new ProbabilisticNearestNeighbor2Opt(instance, 0.3));
-    // experiment.addHeuristic(new ProbabilisticNearestNeighbor2Opt(instance, 0.5));
-    // experiment.addHeuristic(new ProbabilisticNearestNeighbor2Opt(instance, 1.0));
-    // experiment.addHeuristic(new ProbabilisticNearestNeighbor2Opt(instance, 2.0));
-
-    // experiment.addHeuristic(new SequentialNoItems(instance));
-    // experiment.addHeuristic(new NearestNeighborGreedy(instance));
-    // experiment.addHeuristic(new RandomTourGreedy(instance));
-    // experiment.addHeuristic(new HighProfitPicking(instance));
-    
-    experiment.addHeuristic(new HillClimbingPicking(instance));
-    
-    experiment.addHeuristic(new ImprovedHillClimbing(instance));
-    experiment.addHeuristic(new Balanced2Opt(instance));
-    
-    experiment.addHeuristic(new BalancedLNS(instance, 10, 20));
-    experiment.addHeuristic(new BalancedLNS(instance, 15, 30));
-    experiment.addHeuristic(new BalancedLNS(instance, 20, 40));
+    TTPSolution warmStart;
+    bool warmStartItems = false;
+    if (!warmStartPath.empty()) {
+        if (!loadWarmStart(warmStartPath, instanceLabel(positional[0]), instance, warmStart, warmStartItems)) {
+            return 1;
+        }
+        if (warmStart.tour.empty()) {
+            cerr << "Error: No hay soluciones de " << instanceLabel(positional[0]) << " en " << warmStartPath << endl;
+            return 1;
+        }
+        cout << "Warm start: " << warmStartPath << " (objetivo " << warmStart.objective
+             << (warmStartItems ? ", tour e items)" : ", solo tour)") << endl;
+    }
     
-/* 
-    experiment.addHeuristic(new BalancedVNS(instance, 30, 3));
-    experiment.addHeuristic(new BalancedVNS(instance, 50, 5));
-    experiment.addHeuristic(new BalancedVNS(instance, 80, 7));
-*/
+    for (const HeuristicFactory& make : experimentHeuristics()) {
+        TTPHeuristic* heuristic = make(instance);
+        if (!warmStart.tour.empty()) {
+            heuristic->setWarmStart(warmStart, warmStartItems);
+        }
+        experiment.addHeuristic(heuristic);
+    }
     
     experiment.runAll();
     
@@ -2,19 +2,17 @@
 #define TTP_READER_H
 
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <cmath>
+#include "ttp_distance.h"
+#include "ttp_knn.h"
+#include "ttp_parser.h"
+#include "ttp_bitset.h"
+#include "ttp_parallel.h"
 using namespace std;
 
-struct Item {
-    int profit;
-    int weight;
-    int node;  
-};
-
 struct TTPInstance {
     string name;
     int dimension;
@@ -25,91 +23,198 @@ struct TTPInstance {
     double renting_ratio;
     
     vector<pair<double, double>> coords;  // coordenadas de cada ciudad
-    vector<vector<double>> distances;     // matriz de distancias
-    vector<Item> items;                   // items disponibles
+    DistanceProvider distances;           // distancias CEIL_2D calculadas al vuelo
+    // items disponibles como arreglos separados (SoA): el item i vale
+    // item_profit[i], pesa item_weight[i] y está en la ciudad item_node[i]
+    vector<int> item_profit;
+    vector<int> item_weight;
+    vector<int> item_node;
+
+    // índice de items por ciudad (CSR): los items de la ciudad c son
+    // city_items[city_item_start[c]] ... city_items[city_item_start[c + 1] - 1]
+    vector<int> city_item_start;
+    vector<int> city_items;
+
+    // relación profit / weight de cada item, y los items ordenados por esa
+    // relación de mayor a menor (con empate, el de mayor índice primero)
+    vector<double> item_ratio;
+    vector<int> item_order;
+
+    // listas de candidatos: las num_candidates ciudades más cercanas a c son
+    // candidates[c * num_candidates] ... (de la más cercana a la más lejana)
+    int num_candidates;
+    vector<int> candidates;
 };
 
-double calculateDistance(double x1, double y1, double x2, double y2) {
-    double dx = x1 - x2;
-    double dy = y1 - y2;
-    return ceil(sqrt(dx * dx + dy * dy));
+// construir el índice de items por ciudad con un conteo en O(n + m)
+void buildCityItemIndex(TTPInstance& instance) {
+    instance.city_item_start.assign(instance.dimension + 1, 0);
+    for (int i = 0; i < instance.num_items; i++) {
+        instance.city_item_start[instance.item_node[i] + 1]++;
+    }
+    for (int c = 0; c < instance.dimension; c++) {
+        instance.city_item_start[c + 1] += instance.city_item_start[c];
+    }
+
+    instance.city_items.resize(instance.num_items);
+    vector<int> next(instance.city_item_start.begin(), instance.city_item_start.end() - 1);
+    for (int i = 0; i < instance.num_items; i++) {
+        instance.city_items[next[instance.item_node[i]]++] = i;
+    }
+}
+
+void buildItemRatios(TTPInstance& instance) {
+    instance.item_ratio.resize(instance.num_items);
+    for (int i = 0; i < instance.num_items; i++) {
+        instance.item_ratio[i] = (double)instance.item_profit[i] / instance.item_weight[i];
+    }
+    
+    // el orden no depende del tour: se calcula una vez al cargar y lo
+    // comparten todos los planes voraces
+    instance.item_order.resize(instance.num_items);
+    for (int i = 0; i < instance.num_items; i++) instance.item_order[i] = i;
+    const vector<double>& ratio = instance.item_ratio;
+    parallelSort(instance.item_order.begin(), instance.item_order.end(), [&](int a, int b) {
+        return ratio[a] > ratio[b] || (ratio[a] == ratio[b] && a > b);
+    });
+}
+
+// precalcular las k ciudades más cercanas de cada ciudad con un árbol k-d
+void buildCandidateLists(TTPInstance& instance, int k) {
+    k = min(k, instance.dimension - 1);
+    instance.num_candidates = k;
+    instance.candidates.assign((size_t)instance.dimension * k, 0);
+
+    KDTree tree(instance.distances);
+    vector<int> nearest;
+    for (int c = 0; c < instance.dimension; c++) {
+        tree.kNearest(c, k, nearest);
+        copy(nearest.begin(), nearest.end(), instance.candidates.begin() + (size_t)c * k);
+    }
+}
+
+// reportar un error de formato con el archivo y la línea donde ocurrió
+bool parseError(const string& filename, int line, const string& message) {
+    cerr << "Error: " << filename << ":" << line << ": " << message << endl;
+    return false;
 }
 
+// Lee el .ttp mapeándolo en memoria: la cabecera se recorre línea a línea
+// sin crear strings y los números se leen con from_chars directamente
+// del buffer.
 bool readTTPFile(const string& filename, TTPInstance& instance) {
-    ifstream file(filename);
-    if (!file.is_open()) {
+    MappedFile file;
+    if (!file.open(filename)) {
         cerr << "Error: No se pudo abrir el archivo " << filename << endl;
         return false;
     }
     
-    string line;
+    TextScanner scan(file.begin(), file.end());
+    instance.dimension = 0;
+    instance.num_items = 0;
+    instance.capacity = 0;
+    instance.min_speed = 0;
+    instance.max_speed = 0;
+    instance.renting_ratio = 0;
     
-    // leer características
-    while (getline(file, line)) {
-        if (line.find("PROBLEM NAME:") != string::npos) {
-            instance.name = line.substr(line.find(":") + 1);
-        }
-        else if (line.find("DIMENSION:") != string::npos) {
-            sscanf(line.c_str(), "DIMENSION: %d", &instance.dimension);
-        }
-        else if (line.find("NUMBER OF ITEMS:") != string::npos) {
-            sscanf(line.c_str(), "NUMBER OF ITEMS: %d", &instance.num_items);
-        }
-        else if (line.find("CAPACITY OF KNAPSACK:") != string::npos) {
-            sscanf(line.c_str(), "CAPACITY OF KNAPSACK: %d", &instance.capacity);
-        }
-        else if (line.find("MIN SPEED:") != string::npos) {
-            sscanf(line.c_str(), "MIN SPEED: %lf", &instance.min_speed);
-        }
-        else if (line.find("MAX SPEED:") != string::npos) {
-            sscanf(line.c_str(), "MAX SPEED: %lf", &instance.max_speed);
-        }
-        else if (line.find("RENTING RATIO:") != string::npos) {
-            sscanf(line.c_str(), "RENTING RATIO: %lf", &instance.renting_ratio);
-        }
-        else if (line.find("NODE_COORD_SECTION") != string::npos) {
+    // leer características: "CLAVE: valor" hasta NODE_COORD_SECTION
+    bool foundCoords = false;
+    while (!scan.atEnd()) {
+        if (scan.lineStartsWith("NODE_COORD_SECTION")) {
+            scan.nextLine();
+            foundCoords = true;
             break;
         }
+        
+        const char* begin = scan.position();
+        const char* end = scan.lineEnd();
+        const char* colon = (const char*)memchr(begin, ':', end - begin);
+        if (colon) {
+            string_view key(begin, colon - begin);
+            const char* value = colon + 1;
+            while (value < end && (*value == ' ' || *value == '\t')) value++;
+            
+            bool ok = true;
+            if (key == "PROBLEM NAME") {
+                instance.name.assign(value, end);
+            } else if (key == "DIMENSION") {
+                ok = from_chars(value, end, instance.dimension).ec == errc();
+            } else if (key == "NUMBER OF ITEMS") {
+                ok = from_chars(value, end, instance.num_items).ec == errc();
+            } else if (key == "CAPACITY OF KNAPSACK") {
+                ok = from_chars(value, end, instance.capacity).ec == errc();
+            } else if (key == "MIN SPEED") {
+                ok = from_chars(value, end, instance.min_speed).ec == errc();
+            } else if (key == "MAX SPEED") {
+                ok = from_chars(value, end, instance.max_speed).ec == errc();
+            } else if (key == "RENTING RATIO") {
+                ok = from_chars(value, end, instance.renting_ratio).ec == errc();
+            }
+            if (!ok) {
+                return parseError(filename, scan.lineNumber(), "valor invalido para '" + string(key) + "'");
+            }
+        }
+        scan.nextLine();
+    }
+    
+    if (!foundCoords) {
+        return parseError(filename, scan.lineNumber(), "falta NODE_COORD_SECTION");
+    }
+    if (instance.dimension <= 0 || instance.capacity <= 0) {
+        return parseError(filename, scan.lineNumber(), "DIMENSION y CAPACITY OF KNAPSACK deben ser > 0");
     }
     
     // coordenadas de nodos
-    instance.coords.resize(instance.dimension);
+    vector<double> xs(instance.dimension), ys(instance.dimension);
     for (int i = 0; i < instance.dimension; i++) {
-        int idx;
-        double x, y;
-        file >> idx >> x >> y;
-        instance.coords[i] = {x, y};
+        long idx;
+        if (!scan.readNumber(idx) || !scan.readNumber(xs[i]) || !scan.readNumber(ys[i])) {
+            return parseError(filename, scan.lineNumber(), "coordenada " + to_string(i + 1) + " invalida");
+        }
     }
     
-    // calcular matriz de distancias
-    instance.distances.resize(instance.dimension, vector<double>(instance.dimension, 0.0));
+    instance.coords.resize(instance.dimension);
     for (int i = 0; i < instance.dimension; i++) {
-        for (int j = 0; j < instance.dimension; j++) {
-            if (i != j) {
-                instance.distances[i][j] = calculateDistance(
-                    instance.coords[i].first, instance.coords[i].second,
-                    instance.coords[j].first, instance.coords[j].second
-                );
-            }
-        }
+        instance.coords[i] = {xs[i], ys[i]};
     }
     
+    // las distancias se calculan al vuelo desde las coordenadas
+    instance.distances.setCoords(move(xs), move(ys));
+    
     // buscar sección de items
-    while (getline(file, line)) {
-        if (line.find("ITEMS SECTION") != string::npos) {
+    bool foundItems = false;
+    while (!scan.atEnd()) {
+        scan.nextLine();
+        if (scan.lineStartsWith("ITEMS SECTION")) {
+            scan.nextLine();
+            foundItems = true;
             break;
         }
     }
+    if (!foundItems && instance.num_items > 0) {
+        return parseError(filename, scan.lineNumber(), "falta ITEMS SECTION");
+    }
     
     // leer las características de cada ítem
-    instance.items.resize(instance.num_items);
+    instance.item_profit.resize(instance.num_items);
+    instance.item_weight.resize(instance.num_items);
+    instance.item_node.resize(instance.num_items);
     for (int i = 0; i < instance.num_items; i++) {
-        int idx;
-        file >> idx >> instance.items[i].profit >> instance.items[i].weight >> instance.items[i].node;
-        instance.items[i].node--;  
+        long idx;
+        int& node = instance.item_node[i];
+        if (!scan.readNumber(idx) || !scan.readNumber(instance.item_profit[i]) ||
+            !scan.readNumber(instance.item_weight[i]) || !scan.readNumber(node)) {
+            return parseError(filename, scan.lineNumber(), "item " + to_string(i + 1) + " invalido");
+        }
+        if (node < 1 || node > instance.dimension) {
+            return parseError(filename, scan.lineNumber(), "el item " + to_string(i + 1) + " apunta a una ciudad inexistente");
+        }
+        node--;  
     }
     
-    file.close();
+    buildCityItemIndex(instance);
+    buildItemRatios(instance);
+    buildCandidateLists(instance, 20);
     return true;
 }
 
@@ -129,24 +234,22 @@ void printInstanceInfo(const TTPInstance& instance) {
     }
     cout << "\nPrimeros 5 items:" << endl;
     for (int i = 0; i < min(5, instance.num_items); i++) {
-        cout << "  Item " << i << ": profit=" << instance.items[i].profit 
-             << ", weight=" << instance.items[i].weight 
-             << ", ciudad=" << instance.items[i].node << endl;
+        cout << "  Item " << i << ": profit=" << instance.item_profit[i] 
+             << ", weight=" << instance.item_weight[i] 
+             << ", ciudad=" << instance.item_node[i] << endl;
     }
 }
 
 // función para calcular la función objetivo del TTP
-double calculateObjective(const TTPInstance& inst, const vector<int>& tour, const vector<int>& pickingPlan) {
+double calculateObjective(const TTPInstance& inst, const vector<int>& tour, const PickingPlan& pickingPlan) {
     double totalProfit = 0.0;
     double totalTime = 0.0;
     int currentWeight = 0;
     
     // calcular ganancia total
-    for (int i = 0; i < inst.num_items; i++) {
-        if (pickingPlan[i] == 1) {
-            totalProfit += inst.items[i].profit;
-        }
-    }
+    pickingPlan.forEachSelected([&](int i) {
+        totalProfit += inst.item_profit[i];
+    });
     
     // calcular tiempo total del viaje
     double nu = (inst.max_speed - inst.min_speed) / inst.capacity;
@@ -159,12 +262,13 @@ double calculateObjective(const TTPInstance& inst, const vector<int>& tour, cons
         double velocity = inst.max_speed - nu * currentWeight;
         
         // tiempo para este segmento
-        totalTime += inst.distances[from][to] / velocity;
+        totalTime += inst.distances(from, to) / velocity;
         
         // actualizar peso después de visitar 'to'
-        for (int k = 0; k < inst.num_items; k++) {
-            if (pickingPlan[k] == 1 && inst.items[k].node == to) {
-                currentWeight += inst.items[k].weight;
+        for (int j = inst.city_item_start[to]; j < inst.city_item_start[to + 1]; j++) {
+            int k = inst.city_items[j];
+            if (pickingPlan[k]) {
+                currentWeight += inst.item_weight[k];
             }
         }
     }
@@ -0,0 +1,78 @@
+#ifndef TTP_BITSET_H
+#define TTP_BITSET_H
+
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+// ============================================================
+// PLAN DE RECOGIDA COMO CONJUNTO DE BITS
+// ============================================================
+// Un bit por item en palabras de 64 bits: con 44.600 items el plan ocupa
+// 5,6 KB en lugar de 178 KB, así que copiar soluciones y recorrer el plan
+// cuesta muy poco ancho de banda. Los bits sobrantes de la última palabra
+// se mantienen siempre a 0.
+class PickingPlan {
+private:
+    vector<uint64_t> words;
+    int n;
+
+public:
+    explicit PickingPlan(int numItems = 0)
+        : words((numItems + 63) / 64, 0), n(numItems) {}
+
+    int size() const { return n; }
+
+    // dejar numItems bits a 0 reutilizando la memoria ya reservada
+    void assign(int numItems) {
+        words.assign((numItems + 63) / 64, 0);
+        n = numItems;
+    }
+
+    bool operator[](int i) const {
+        return (words[i >> 6] >> (i & 63)) & 1;
+    }
+
+    void set(int i) { words[i >> 6] |= 1ULL << (i & 63); }
+    void reset(int i) { words[i >> 6] &= ~(1ULL << (i & 63)); }
+    void flip(int i) { words[i >> 6] ^= 1ULL << (i & 63); }
+
+    // número de items seleccionados
+    int count() const {
+        int total = 0;
+        for (uint64_t w : words) total += __builtin_popcountll(w);
+        return total;
+    }
+
+    // llamar f(i) para cada item seleccionado, en orden creciente
+    template <typename F>
+    void forEachSelected(F f) const {
+        for (size_t w = 0; w < words.size(); w++) {
+            uint64_t bits = words[w];
+            while (bits) {
+                f((int)(w * 64 + __builtin_ctzll(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    // llamar f(i) para cada item en que este plan y 'other' (del mismo
+    // tamaño) difieren, en orden creciente
+    template <typename F>
+    void forEachDifferent(const PickingPlan& other, F f) const {
+        for (size_t w = 0; w < words.size(); w++) {
+            uint64_t bits = words[w] ^ other.words[w];
+            while (bits) {
+                f((int)(w * 64 + __builtin_ctzll(bits)));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    bool operator==(const PickingPlan& other) const {
+        return n == other.n && words == other.words;
+    }
+};
+
+#endif
@@ -0,0 +1,332 @@
+#ifndef TTP_CACHE_H
+#define TTP_CACHE_H
+
+#include "reader.cpp"
+#include "ttp_parser.h"
+#include <fstream>
+#include <cstdint>
+#include <cstdio>
+#include <climits>
+#include <cstdlib>
+
+using namespace std;
+
+// ============================================================
+// CACHÉ BINARIA DE INSTANCIAS
+// ============================================================
+// La primera vez que se carga un .ttp se guarda una copia binaria ya
+// preprocesada (coordenadas, índice CSR de items, ratios y su orden, y
+// listas de candidatos) en el directorio de caché. Las cargas siguientes
+// mapean ese archivo en solo lectura y copian cada sección de una vez, sin
+// parsear texto, ordenar items ni reconstruir el árbol k-d.
+//
+// Formato (enteros y reales en el orden de bytes de la máquina):
+//   cabecera fija TTPCacheHeader
+//   secciones alineadas a 64 bytes en las posiciones de 'offsets'
+// La cabecera guarda el tamaño y la fecha del .ttp de origen: si cambian,
+// la caché se descarta y se vuelve a escribir. También guarda una suma de
+// control de todo lo que sigue a la cabecera, y los índices se comprueban
+// antes de usarlos: una caché truncada o corrupta se descarta igual.
+
+const uint32_t TTP_CACHE_VERSION = 3;
+const uint64_t TTP_CACHE_ALIGN = 64;
+
+enum TTPCacheSection {
+    CACHE_NAME,         // char[name_length]
+    CACHE_X,            // double[dimension]
+    CACHE_Y,            // double[dimension]
+    CACHE_PROFIT,       // int32[num_items]
+    CACHE_WEIGHT,       // int32[num_items]
+    CACHE_NODE,         // int32[num_items]
+    CACHE_ITEM_START,   // int32[dimension + 1]
+    CACHE_CITY_ITEMS,   // int32[num_items]
+    CACHE_RATIO,        // double[num_items]
+    CACHE_ITEM_ORDER,   // int32[num_items]
+    CACHE_CANDIDATES,   // int32[dimension * num_candidates]
+    CACHE_NUM_SECTIONS
+};
+
+struct TTPCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint64_t file_size;
+    uint64_t source_size;
+    int64_t source_mtime;
+
+    int32_t dimension;
+    int32_t num_items;
+    int32_t capacity;
+    int32_t num_candidates;   // 0 si no se guardaron candidatos
+    double min_speed;
+    double max_speed;
+    double renting_ratio;
+    uint64_t name_length;
+    uint64_t checksum;        // cacheChecksum de los bytes tras la cabecera
+
+    uint64_t offsets[CACHE_NUM_SECTIONS];
+};
+
+// tamaño en bytes de cada sección según las dimensiones de la cabecera
+uint64_t cacheSectionSize(const TTPCacheHeader& h, int section) {
+    uint64_t n = h.dimension, m = h.num_items;
+    switch (section) {
+        case CACHE_NAME:       return h.name_length;
+        case CACHE_X:
+        case CACHE_Y:          return n * sizeof(double);
+        case CACHE_PROFIT:
+        case CACHE_WEIGHT:
+        case CACHE_NODE:
+        case CACHE_CITY_ITEMS:
+        case CACHE_ITEM_ORDER: return m * sizeof(int32_t);
+        case CACHE_ITEM_START: return (n + 1) * sizeof(int32_t);
+        case CACHE_RATIO:      return m * sizeof(double);
+        case CACHE_CANDIDATES: return n * (uint64_t)h.num_candidates * sizeof(int32_t);
+    }
+    return 0;
+}
+
+// FNV-1a de 64 bits tomando palabras de 8 bytes (el final byte a byte)
+uint64_t cacheChecksum(const char* data, uint64_t size) {
+    uint64_t hash = 1469598103934665603ULL;
+    uint64_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * 1099511628211ULL;
+    }
+    for (; i < size; i++) {
+        hash = (hash ^ (unsigned char)data[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// true si los 'count' int32 a partir de 'data' están en [0, limit)
+bool cacheIndicesInRange(const char* data, uint64_t count, int32_t limit) {
+    for (uint64_t i = 0; i < count; i++) {
+        int32_t value;
+        memcpy(&value, data + i * sizeof(int32_t), sizeof(int32_t));
+        if (value < 0 || value >= limit) return false;
+    }
+    return true;
+}
+
+// el índice CSR empieza en 0, termina en m y no decrece
+bool cacheItemStartValid(const char* data, int n, int m) {
+    int32_t previous = 0;
+    for (int i = 0; i <= n; i++) {
+        int32_t value;
+        memcpy(&value, data + (uint64_t)i * sizeof(int32_t), sizeof(int32_t));
+        if ((i == 0 && value != 0) || value < previous) return false;
+        previous = value;
+    }
+    return previous == m;
+}
+
+// tamaño y fecha de modificación (en ns) del archivo de origen
+bool sourceSignature(const string& filename, uint64_t& size, int64_t& mtime) {
+    struct stat st;
+    if (stat(filename.c_str(), &st) != 0) return false;
+    size = st.st_size;
+    mtime = (int64_t)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+    return true;
+}
+
+// ruta de la caché: nombre del .ttp más un hash de su ruta absoluta, para
+// que instancias homónimas en carpetas distintas no se pisen
+string cachePathFor(const string& filename, const string& cacheDir) {
+    char resolved[PATH_MAX];
+    string full = realpath(filename.c_str(), resolved) ? string(resolved) : filename;
+
+    uint64_t hash = 1469598103934665603ULL;   // FNV-1a
+    for (unsigned char c : full) {
+        hash = (hash ^ c) * 1099511628211ULL;
+    }
+
+    string base = full.substr(full.find_last_of('/') + 1);
+    if (base.size() > 4 && base.compare(base.size() - 4, 4, ".ttp") == 0) {
+        base.resize(base.size() - 4);
+    }
+
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), "-%016llx.ttpb", (unsigned long long)hash);
+    return cacheDir + "/" + base + suffix;
+}
+
+// Carga la instancia desde la caché; devuelve false (sin mensajes) si no
+// existe, es de otra versión, no corresponde al .ttp actual o está dañada.
+// Todo se comprueba antes de tocar 'instance'.
+bool readInstanceCache(const string& cachePath, uint64_t sourceSize, int64_t sourceMtime,
+                       TTPInstance& instance) {
+    MappedFile file;
+    if (!file.open(cachePath) || file.size() < sizeof(TTPCacheHeader)) return false;
+
+    TTPCacheHeader h;
+    memcpy(&h, file.begin(), sizeof(h));
+    if (memcmp(h.magic, "TTPCACHE", 8) != 0 || h.version != TTP_CACHE_VERSION ||
+        h.header_size != sizeof(TTPCacheHeader) || h.file_size != file.size() ||
+        h.source_size != sourceSize || h.source_mtime != sourceMtime ||
+        h.dimension <= 0 || h.num_items < 0 || h.num_candidates < 0) {
+        return false;
+    }
+    for (int s = 0; s < CACHE_NUM_SECTIONS; s++) {
+        if (h.offsets[s] > h.file_size || cacheSectionSize(h, s) > h.file_size - h.offsets[s]) {
+            return false;
+        }
+    }
+    if (cacheChecksum(file.begin() + sizeof(h), h.file_size - sizeof(h)) != h.checksum) {
+        return false;
+    }
+
+    auto section = [&](int s) { return file.begin() + h.offsets[s]; };
+    auto copySection = [&](int s, auto& out) {
+        memcpy(out.data(), section(s), cacheSectionSize(h, s));
+    };
+
+    int n = h.dimension, m = h.num_items;
+    if (!cacheIndicesInRange(section(CACHE_NODE), m, n) ||
+        !cacheItemStartValid(section(CACHE_ITEM_START), n, m) ||
+        !cacheIndicesInRange(section(CACHE_CITY_ITEMS), m, m) ||
+        !cacheIndicesInRange(section(CACHE_ITEM_ORDER), m, m) ||
+        !cacheIndicesInRange(section(CACHE_CANDIDATES), (uint64_t)n * h.num_candidates, n)) {
+        return false;
+    }
+
+    instance.name.assign(section(CACHE_NAME), h.name_length);
+    instance.dimension = n;
+    instance.num_items = m;
+    instance.capacity = h.capacity;
+    instance.min_speed = h.min_speed;
+    instance.max_speed = h.max_speed;
+    instance.renting_ratio = h.renting_ratio;
+
+    vector<double> xs(n), ys(n);
+    copySection(CACHE_X, xs);
+    copySection(CACHE_Y, ys);
+    instance.coords.resize(n);
+    for (int i = 0; i < n; i++) {
+        instance.coords[i] = {xs[i], ys[i]};
+    }
+    instance.distances.setCoords(move(xs), move(ys));
+
+    instance.item_profit.resize(m);
+    instance.item_weight.resize(m);
+    instance.item_node.resize(m);
+    copySection(CACHE_PROFIT, instance.item_profit);
+    copySection(CACHE_WEIGHT, instance.item_weight);
+    copySection(CACHE_NODE, instance.item_node);
+
+    instance.city_item_start.resize(n + 1);
+    instance.city_items.resize(m);
+    instance.item_ratio.resize(m);
+    instance.item_order.resize(m);
+    copySection(CACHE_ITEM_START, instance.city_item_start);
+    copySection(CACHE_CITY_ITEMS, instance.city_items);
+    copySection(CACHE_RATIO, instance.item_ratio);
+    copySection(CACHE_ITEM_ORDER, instance.item_order);
+
+    if (h.num_candidates > 0) {
+        instance.num_candidates = h.num_candidates;
+        instance.candidates.resize((size_t)n * h.num_candidates);
+        copySection(CACHE_CANDIDATES, instance.candidates);
+    } else {
+        buildCandidateLists(instance, 20);
+    }
+    return true;
+}
+
+// Escribe la caché en un archivo temporal y lo renombra al final, para que
+// otra ejecución que lea a la vez nunca vea un archivo a medias.
+bool writeInstanceCache(const string& cachePath, uint64_t sourceSize, int64_t sourceMtime,
+                        const TTPInstance& instance) {
+    TTPCacheHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, "TTPCACHE", 8);
+    h.version = TTP_CACHE_VERSION;
+    h.header_size = sizeof(TTPCacheHeader);
+    h.source_size = sourceSize;
+    h.source_mtime = sourceMtime;
+    h.dimension = instance.dimension;
+    h.num_items = instance.num_items;
+    h.capacity = instance.capacity;
+    h.num_candidates = instance.num_candidates;
+    h.min_speed = instance.min_speed;
+    h.max_speed = instance.max_speed;
+    h.renting_ratio = instance.renting_ratio;
+    h.name_length = instance.name.size();
+
+    uint64_t offset = sizeof(TTPCacheHeader);
+    for (int s = 0; s < CACHE_NUM_SECTIONS; s++) {
+        offset = (offset + TTP_CACHE_ALIGN - 1) / TTP_CACHE_ALIGN * TTP_CACHE_ALIGN;
+        h.offsets[s] = offset;
+        offset += cacheSectionSize(h, s);
+    }
+    h.file_size = offset;
+
+    int n = instance.dimension;
+    vector<char> buffer(h.file_size, 0);
+    auto put = [&](int s, const void* data) {
+        memcpy(buffer.data() + h.offsets[s], data, cacheSectionSize(h, s));
+    };
+
+    vector<double> xs(n), ys(n);
+    for (int i = 0; i < n; i++) {
+        xs[i] = instance.distances.x(i);
+        ys[i] = instance.distances.y(i);
+    }
+
+    memcpy(buffer.data(), &h, sizeof(h));
+    put(CACHE_NAME, instance.name.data());
+    put(CACHE_X, xs.data());
+    put(CACHE_Y, ys.data());
+    put(CACHE_PROFIT, instance.item_profit.data());
+    put(CACHE_WEIGHT, instance.item_weight.data());
+    put(CACHE_NODE, instance.item_node.data());
+    put(CACHE_ITEM_START, instance.city_item_start.data());
+    put(CACHE_CITY_ITEMS, instance.city_items.data());
+    put(CACHE_RATIO, instance.item_ratio.data());
+    put(CACHE_ITEM_ORDER, instance.item_order.data());
+    put(CACHE_CANDIDATES, instance.candidates.data());
+    h.checksum = cacheChecksum(buffer.data() + sizeof(h), h.file_size - sizeof(h));
+    memcpy(buffer.data(), &h, sizeof(h));
+
+    string tmpPath = cachePath + ".tmp" + to_string(getpid());
+    {
+        ofstream out(tmpPath, ios::binary);
+        if (!out.write(buffer.data(), buffer.size())) {
+            remove(tmpPath.c_str());
+            return false;
+        }
+    }
+    if (rename(tmpPath.c_str(), cachePath.c_str()) != 0) {
+        remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Carga una instancia usando la caché de cacheDir (vacío = sin caché). Si
+// no hay caché válida se lee el .ttp y se guarda la caché para la próxima.
+bool loadInstance(const string& filename, TTPInstance& instance, const string& cacheDir) {
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    if (cacheDir.empty() || !sourceSignature(filename, sourceSize, sourceMtime)) {
+        return readTTPFile(filename, instance);
+    }
+
+    string cachePath = cachePathFor(filename, cacheDir);
+    if (readInstanceCache(cachePath, sourceSize, sourceMtime, instance)) {
+        return true;
+    }
+
+    if (!readTTPFile(filename, instance)) {
+        return false;
+    }
+    mkdir(cacheDir.c_str(), 0755);
+    if (!writeInstanceCache(cachePath, sourceSize, sourceMtime, instance)) {
+        cerr << "Aviso: no se pudo escribir la cache " << cachePath << endl;
+    }
+    return true;
+}
+
+#endif
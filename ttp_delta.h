@@ -0,0 +1,283 @@
+#ifndef TTP_DELTA_H
+#define TTP_DELTA_H
+
+#include "reader.cpp"
+#include "ttp_batch.h"
+#include <vector>
+#include <limits>
+#include <cmath>
+
+using namespace std;
+
+// ============================================================
+// EVALUACIÓN INCREMENTAL DE FLIPS DE ITEMS
+// ============================================================
+// Mantiene, para un tour fijo, la distancia y el peso cargado en cada arista
+// junto con sus sumas acumuladas. Invertir el item k (de la ciudad en la
+// posición p) solo cambia el peso de las aristas p..n-1, así que:
+//   - flipDelta:      cambio exacto del objetivo en O(n - p)
+//   - flipDeltaBatch: flipDelta de varios items a la vez con SIMD (ttp_batch.h)
+//   - flipDeltaFast:  cambio del objetivo en O(log n) con un árbol de segmentos
+//   - flipUpperBound: cota superior en O(1) para descartar flips sin evaluar
+class PickingDeltaEvaluator {
+private:
+    // términos de la serie 1/(u - x) = sum_k x^k / u^(k+1) guardados por nodo
+    static const int TERMS = 10;
+
+    const TTPInstance& instance;
+    double nu;
+    int n;
+    int treeSize;
+
+    vector<int> position;        // posición de cada ciudad en el tour
+    vector<double> edgeDist;     // distancia de la arista i: tour[i] -> tour[i+1]
+    vector<double> suffixDist;   // distancia acumulada de las aristas i..n-1
+    vector<int> edgeWeight;      // peso cargado al recorrer la arista i
+    vector<double> prefixTime;   // tiempo acumulado de las aristas 0..i-1
+    vector<double> tree;         // sumas d_i / u_i^(k+1) por nodo del árbol
+
+    double profit;
+    int weight;
+
+    double velocity(double w) const {
+        double v = instance.max_speed - nu * w;
+        return v < instance.min_speed ? instance.min_speed : v;
+    }
+
+    void setLeaf(int i) {
+        double* leaf = &tree[(size_t)(treeSize + i) * TERMS];
+        double inv = 1.0 / velocity(edgeWeight[i]);
+        double term = edgeDist[i] * inv;
+        for (int k = 0; k < TERMS; k++) {
+            leaf[k] = term;
+            term *= inv;
+        }
+    }
+
+    void pullNode(int node) {
+        double* dst = &tree[(size_t)node * TERMS];
+        const double* l = &tree[(size_t)(2 * node) * TERMS];
+        const double* r = &tree[(size_t)(2 * node + 1) * TERMS];
+        for (int k = 0; k < TERMS; k++) dst[k] = l[k] + r[k];
+    }
+
+    // recalcular pesos, tiempos y hojas desde la posición 'from' hasta el final
+    void refreshSuffix(int from) {
+        for (int i = from; i < n; i++) {
+            prefixTime[i + 1] = prefixTime[i] + edgeDist[i] / velocity(edgeWeight[i]);
+        }
+        for (int i = from; i < n; i++) setLeaf(i);
+
+        int lo = (treeSize + from) >> 1;
+        int hi = (treeSize + n - 1) >> 1;
+        while (lo >= 1) {
+            for (int node = lo; node <= hi; node++) pullNode(node);
+            lo >>= 1;
+            hi >>= 1;
+        }
+    }
+
+    int itemPosition(int k) const {
+        return position[instance.item_node[k]];
+    }
+
+public:
+    PickingDeltaEvaluator(const TTPInstance& inst)
+        : instance(inst),
+          nu((inst.max_speed - inst.min_speed) / inst.capacity),
+          n(0), treeSize(1), prefixTime(1, 0.0), profit(0), weight(0) {}
+
+    void reset(const vector<int>& tour, const PickingPlan& pickingPlan) {
+        n = tour.size();
+        treeSize = 1;
+        while (treeSize < n) treeSize <<= 1;
+
+        position.assign(instance.dimension, 0);
+        for (int i = 0; i < n; i++) position[tour[i]] = i;
+
+        edgeDist.resize(n);
+        for (int i = 0; i < n; i++) {
+            edgeDist[i] = instance.distances(tour[i], tour[(i + 1) % n]);
+        }
+        suffixDist.assign(n + 1, 0.0);
+        for (int i = n - 1; i >= 0; i--) suffixDist[i] = suffixDist[i + 1] + edgeDist[i];
+
+        profit = 0;
+        weight = 0;
+        pickingPlan.forEachSelected([&](int k) {
+            profit += instance.item_profit[k];
+            weight += instance.item_weight[k];
+        });
+
+        // peso cargado en cada arista: lo recogido en tour[1..i]
+        edgeWeight.assign(n, 0);
+        int carried = 0;
+        for (int i = 0; i < n; i++) {
+            edgeWeight[i] = carried;
+            int to = tour[(i + 1) % n];
+            for (int j = instance.city_item_start[to]; j < instance.city_item_start[to + 1]; j++) {
+                if (pickingPlan[instance.city_items[j]]) {
+                    carried += instance.item_weight[instance.city_items[j]];
+                }
+            }
+        }
+
+        prefixTime.assign(n + 1, 0.0);
+        tree.assign((size_t)2 * treeSize * TERMS, 0.0);
+        refreshSuffix(0);
+    }
+
+    double getProfit() const { return profit; }
+    int getWeight() const { return weight; }
+    double getTime() const { return prefixTime[n]; }
+    double objective() const { return profit - getTime() * instance.renting_ratio; }
+
+    // cota superior del cambio del objetivo, usando que la velocidad a lo
+    // largo del sufijo está entre la de la arista p y la de la última arista
+    double flipUpperBound(const PickingPlan& pickingPlan, int k) const {
+        int w = instance.item_weight[k];
+        int sign = pickingPlan[k] ? -1 : 1;
+        if (weight + sign * w > instance.capacity) {
+            return -numeric_limits<double>::infinity();
+        }
+
+        int p = itemPosition(k);
+        if (p == 0) return sign * instance.item_profit[k];
+
+        double minTime;
+        if (sign > 0) {
+            minTime = suffixDist[p] * (1.0 / velocity(edgeWeight[p] + w) - 1.0 / velocity(edgeWeight[p]));
+        } else {
+            minTime = suffixDist[p] * (1.0 / velocity(edgeWeight[n - 1] - w) - 1.0 / velocity(edgeWeight[n - 1]));
+        }
+        return sign * instance.item_profit[k] - minTime * instance.renting_ratio;
+    }
+
+    // cambio exacto del objetivo al invertir el item k, en O(n - p)
+    double flipDelta(const PickingPlan& pickingPlan, int k) const {
+        int w = instance.item_weight[k];
+        int sign = pickingPlan[k] ? -1 : 1;
+        if (weight + sign * w > instance.capacity) {
+            return -numeric_limits<double>::infinity();
+        }
+
+        int p = itemPosition(k);
+        double newTime = 0.0;
+        if (p > 0) {
+            int delta = sign * w;
+            for (int i = p; i < n; i++) {
+                newTime += edgeDist[i] / velocity(edgeWeight[i] + delta);
+            }
+            newTime -= prefixTime[n] - prefixTime[p];
+        }
+        return sign * instance.item_profit[k] - newTime * instance.renting_ratio;
+    }
+
+    // flipDelta de items[0..count-1] contra el plan actual (mismos valores):
+    // se evalúan de a tantos como carriles tenga el SIMD, recorriendo una
+    // sola vez el sufijo desde la menor posición del grupo
+    void flipDeltaBatch(const PickingPlan& pickingPlan, const int* items, int count, double* out) {
+        int L = activeSimdLevel();
+        SuffixTimesKernel kernel = suffixTimesKernel();
+        SpeedModel speed = {instance.max_speed, instance.min_speed, nu};
+        double start[8], shift[8], times[8];
+        int lane[8];
+
+        int k = 0;
+        while (k < count) {
+            // llenar un grupo con los flips que necesitan recorrer el sufijo
+            int used = 0;
+            for (; k < count && used < L; k++) {
+                int item = items[k];
+                int w = instance.item_weight[item];
+                int sign = pickingPlan[item] ? -1 : 1;
+                int p = itemPosition(item);
+                if (weight + sign * w > instance.capacity) {
+                    out[k] = -numeric_limits<double>::infinity();
+                } else if (p == 0) {
+                    out[k] = sign * instance.item_profit[item];
+                } else {
+                    start[used] = p;
+                    shift[used] = sign * w;
+                    lane[used++] = k;
+                }
+            }
+            if (used == 0) continue;
+            for (int l = used; l < L; l++) {
+                start[l] = n;   // carril vacío: nunca activo
+                shift[l] = 0;
+            }
+
+            kernel(speed, edgeDist.data(), edgeWeight.data(), n, start, shift, times);
+            for (int l = 0; l < used; l++) {
+                int item = items[lane[l]];
+                int p = (int)start[l];
+                int sign = shift[l] < 0 ? -1 : 1;
+                double newTime = times[l] - (prefixTime[n] - prefixTime[p]);
+                out[lane[l]] = sign * instance.item_profit[item] - newTime * instance.renting_ratio;
+            }
+        }
+    }
+
+    // cambio del objetivo en O(log n): suma la serie de Taylor de 1/(u - x)
+    // sobre el sufijo con el árbol de segmentos. Si la serie no converge
+    // lo suficiente (item muy pesado respecto a la velocidad mínima del
+    // sufijo) se usa la evaluación exacta.
+    double flipDeltaFast(const PickingPlan& pickingPlan, int k) const {
+        int w = instance.item_weight[k];
+        int sign = pickingPlan[k] ? -1 : 1;
+        if (weight + sign * w > instance.capacity) {
+            return -numeric_limits<double>::infinity();
+        }
+
+        int p = itemPosition(k);
+        if (p == 0) return sign * instance.item_profit[k];
+
+        double x = nu * sign * w;
+        double r = fabs(x) / velocity(edgeWeight[n - 1]);
+        if (r > 0.15) return flipDelta(pickingPlan, k);
+
+        double sums[TERMS] = {0};
+        int lo = treeSize + p;
+        int hi = treeSize + n;
+        while (lo < hi) {
+            if (lo & 1) {
+                const double* node = &tree[(size_t)lo * TERMS];
+                for (int t = 0; t < TERMS; t++) sums[t] += node[t];
+                lo++;
+            }
+            if (hi & 1) {
+                hi--;
+                const double* node = &tree[(size_t)hi * TERMS];
+                for (int t = 0; t < TERMS; t++) sums[t] += node[t];
+            }
+            lo >>= 1;
+            hi >>= 1;
+        }
+
+        double deltaTime = 0.0;
+        double xp = x;
+        for (int t = 1; t < TERMS; t++) {
+            deltaTime += xp * sums[t];
+            xp *= x;
+        }
+        return sign * instance.item_profit[k] - deltaTime * instance.renting_ratio;
+    }
+
+    // aplicar el flip del item k al plan y a los acumulados, en O(n - p)
+    void applyFlip(PickingPlan& pickingPlan, int k) {
+        int sign = pickingPlan[k] ? -1 : 1;
+        int delta = sign * instance.item_weight[k];
+        pickingPlan.flip(k);
+
+        profit += sign * instance.item_profit[k];
+        weight += delta;
+
+        int p = itemPosition(k);
+        if (p == 0) return;
+        for (int i = p; i < n; i++) edgeWeight[i] += delta;
+        refreshSuffix(p);
+    }
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef TTP_DISTANCE_H
+#define TTP_DISTANCE_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <cstdint>
+#include <cmath>
+
+using namespace std;
+
+double calculateDistance(double x1, double y1, double x2, double y2) {
+    double dx = x1 - x2;
+    double dy = y1 - y2;
+    return ceil(sqrt(dx * dx + dy * dy));
+}
+
+// ============================================================
+// PROVEEDOR DE DISTANCIAS CEIL_2D
+// ============================================================
+// Calcula las distancias al vuelo desde las coordenadas guardadas como
+// arreglos separados (x[], y[]), así la memoria es O(n) en lugar de la
+// matriz n x n. Opcionalmente guarda las distancias ya calculadas en una
+// caché acotada de correspondencia directa; cada entrada es un único entero
+// atómico (clave + distancia), por lo que varios hilos pueden consultarla
+// a la vez sin bloqueos.
+class DistanceProvider {
+private:
+    vector<double> xs;
+    vector<double> ys;
+
+    unique_ptr<atomic<uint64_t>[]> cache;
+    size_t cacheMask;
+
+    double compute(int i, int j) const {
+        return calculateDistance(xs[i], ys[i], xs[j], ys[j]);
+    }
+
+public:
+    DistanceProvider() : cacheMask(0) {}
+
+    void setCoords(const vector<pair<double, double>>& coords) {
+        xs.resize(coords.size());
+        ys.resize(coords.size());
+        for (size_t i = 0; i < coords.size(); i++) {
+            xs[i] = coords[i].first;
+            ys[i] = coords[i].second;
+        }
+    }
+
+    void setCoords(vector<double>&& x, vector<double>&& y) {
+        xs = move(x);
+        ys = move(y);
+    }
+
+    // activar la caché con a lo sumo maxEntries entradas (0 la desactiva)
+    void enableCache(size_t maxEntries) {
+        cache.reset();
+        cacheMask = 0;
+        if (maxEntries == 0 || xs.size() > 65535) return;
+
+        size_t size = 1;
+        while (size * 2 <= maxEntries) size *= 2;
+        cache.reset(new atomic<uint64_t>[size]);
+        for (size_t k = 0; k < size; k++) cache[k].store(0, memory_order_relaxed);
+        cacheMask = size - 1;
+    }
+
+    int size() const { return xs.size(); }
+    double x(int i) const { return xs[i]; }
+    double y(int i) const { return ys[i]; }
+
+    double operator()(int i, int j) const {
+        if (!cache) return compute(i, j);
+
+        // la distancia es simétrica: una sola entrada para (i, j) y (j, i)
+        if (i > j) swap(i, j);
+        uint32_t key = (uint32_t)i * (uint32_t)xs.size() + (uint32_t)j + 1;
+        size_t slot = (key * 0x9E3779B97F4A7C15ULL >> 20) & cacheMask;
+
+        uint64_t entry = cache[slot].load(memory_order_relaxed);
+        if ((uint32_t)(entry >> 32) == key) {
+            return (double)(uint32_t)entry;
+        }
+
+        double d = compute(i, j);
+        cache[slot].store(((uint64_t)key << 32) | (uint32_t)d, memory_order_relaxed);
+        return d;
+    }
+};
+
+#endif
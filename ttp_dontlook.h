@@ -0,0 +1,61 @@
+#ifndef TTP_DONTLOOK_H
+#define TTP_DONTLOOK_H
+
+#include <vector>
+
+using namespace std;
+
+// ============================================================
+// COLA DE CIUDADES PENDIENTES (DON'T-LOOK BITS)
+// ============================================================
+// Cada ciudad tiene un bit "pendiente". La búsqueda local solo explora los
+// movimientos alrededor de las ciudades de la cola; si una ciudad no da
+// ningún movimiento de mejora sale de la cola (su bit queda apagado) y no
+// se vuelve a mirar hasta que un movimiento cambie una arista que la toque.
+// Cola FIFO circular: cada ciudad está a lo sumo una vez, así que basta con
+// capacidad para todas las ciudades.
+class DirtyQueue {
+private:
+    vector<int> ring;
+    vector<char> queued;
+    int head;
+    int count;
+
+public:
+    DirtyQueue() : head(0), count(0) {}
+
+    // vaciar la cola para 'dimension' ciudades
+    void clear(int dimension) {
+        ring.resize(dimension);
+        queued.assign(dimension, 0);
+        head = 0;
+        count = 0;
+    }
+
+    // todas las ciudades pendientes, en el orden del tour
+    void fill(const vector<int>& tour) {
+        clear(tour.size());
+        for (int city : tour) push(city);
+    }
+
+    bool empty() const { return count == 0; }
+
+    void push(int city) {
+        if (queued[city]) return;
+        queued[city] = 1;
+        int slot = head + count;
+        if (slot >= (int)ring.size()) slot -= ring.size();
+        ring[slot] = city;
+        count++;
+    }
+
+    int pop() {
+        int city = ring[head];
+        queued[city] = 0;
+        if (++head == (int)ring.size()) head = 0;
+        count--;
+        return city;
+    }
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef TTP_EVALUATOR_H
+#define TTP_EVALUATOR_H
+
+#include "reader.cpp"
+#include <vector>
+
+using namespace std;
+
+// resultado de evaluar un tour junto a un plan de recogida
+struct TTPEvaluation {
+    double objective;
+    double profit;
+    double time;
+    int weight;
+};
+
+// ============================================================
+// EVALUADOR LINEAL DEL TTP
+// ============================================================
+// Recorre los items una vez para la ganancia/peso y el tour una vez para el
+// tiempo, usando el índice CSR de items por ciudad del TTPInstance: O(n + m)
+// por evaluación en lugar de O(n * m).
+class TTPEvaluator {
+private:
+    const TTPInstance& instance;
+    double nu;
+
+public:
+    TTPEvaluator(const TTPInstance& inst)
+        : instance(inst),
+          nu((inst.max_speed - inst.min_speed) / inst.capacity) {}
+
+    TTPEvaluation evaluate(const vector<int>& tour, const PickingPlan& pickingPlan) const {
+        TTPEvaluation ev;
+        ev.profit = 0.0;
+        ev.time = 0.0;
+        ev.weight = 0;
+
+        pickingPlan.forEachSelected([&](int i) {
+            ev.profit += instance.item_profit[i];
+            ev.weight += instance.item_weight[i];
+        });
+
+        if (ev.weight > instance.capacity) {
+            ev.objective = -1e9;
+            ev.time = 1e9;
+            return ev;
+        }
+
+        int currentWeight = 0;
+        for (int i = 0; i < instance.dimension; i++) {
+            int from = tour[i];
+            int to = tour[(i + 1) % instance.dimension];
+
+            double velocity = instance.max_speed - nu * currentWeight;
+            if (velocity < instance.min_speed) {
+                velocity = instance.min_speed;
+            }
+
+            ev.time += instance.distances(from, to) / velocity;
+
+            // recoger solo los items de la ciudad 'to'
+            for (int j = instance.city_item_start[to]; j < instance.city_item_start[to + 1]; j++) {
+                int k = instance.city_items[j];
+                if (pickingPlan[k]) {
+                    currentWeight += instance.item_weight[k];
+                }
+            }
+        }
+
+        ev.objective = ev.profit - ev.time * instance.renting_ratio;
+        return ev;
+    }
+};
+
+#endif
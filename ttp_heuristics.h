@@ -12,6 +12,10 @@
 // public:
 //     SequentialNoItems(const TTPInstance& inst) : TTPHeuristic(inst) {}
 //     
+//     TTPHeuristic* clone() const override {
+//         return new SequentialNoItems(*this);
+//     }
+//     
 //     string getName() const override {
 //         return "Sequential Tour + No Items";
 //     }
@@ -32,6 +36,10 @@
 // public:
 //     NearestNeighborGreedy(const TTPInstance& inst) : TTPHeuristic(inst) {}
 //     
+//     TTPHeuristic* clone() const override {
+//         return new NearestNeighborGreedy(*this);
+//     }
+//     
 //     string getName() const override {
 //         return "Nearest Neighbor + Greedy Picking";
 //     }
@@ -50,8 +58,10 @@
 // // HEURÍSTICA C: Tour aleatorio + Picking greedy
 // class RandomTourGreedy : public TTPHeuristic {
 // public:
-//     RandomTourGreedy(const TTPInstance& inst) : TTPHeuristic(inst) {
-//         srand(time(0));
+//     RandomTourGreedy(const TTPInstance& inst) : TTPHeuristic(inst) {}
+//     
+//     TTPHeuristic* clone() const override {
+//         return new RandomTourGreedy(*this);
 //     }
 //     
 //     string getName() const override {
@@ -74,6 +84,10 @@
 // public:
 //     HighProfitPicking(const TTPInstance& inst) : TTPHeuristic(inst) {}
 //     
+//     TTPHeuristic* clone() const override {
+//         return new HighProfitPicking(*this);
+//     }
+//     
 //     string getName() const override {
 //         return "Nearest Neighbor + High Profit Picking";
 //     }
@@ -85,7 +99,7 @@
 //         // Crear picking plan basado en profit absoluto
 //         vector<pair<int, int>> itemsByProfit; // (profit, index)
 //         for (int i = 0; i < instance.num_items; i++) {
-//             itemsByProfit.push_back({instance.items[i].profit, i});
+//             itemsByProfit.push_back({instance.item_profit[i], i});
 //         }
 //         sort(itemsByProfit.rbegin(), itemsByProfit.rend());
 //         
@@ -94,9 +108,9 @@
 //         
 //         for (auto& p : itemsByProfit) {
 //             int itemIdx = p.second;
-//             if (currentWeight + instance.items[itemIdx].weight <= instance.capacity) {
-//                 sol.pickingPlan[itemIdx] = 1;
-//                 currentWeight += instance.items[itemIdx].weight;
+//             if (currentWeight + instance.item_weight[itemIdx] <= instance.capacity) {
+//                 sol.pickingPlan.set(itemIdx);
+//                 currentWeight += instance.item_weight[itemIdx];
 //             }
 //         }
 //         
@@ -112,88 +126,18 @@
 
 class OptimizedTTPHeuristic : public TTPHeuristic {
 protected:
-    // 2-Opt limitado: solo revisa vecinos cercanos
-    bool improve2OptLimited(TTPSolution& sol, int maxNeighbors = 20) {
-        bool improved = false;
-        int n = sol.tour.size();
-        
-        for (int i = 1; i < n - 1; i++) {
-            // Limitar j para reducir el espacio de búsqueda
-            int jMax = min(i + maxNeighbors, n);
-            
-            for (int j = i + 1; j < jMax; j++) {
-                reverse(sol.tour.begin() + i, sol.tour.begin() + j + 1);
-                
-                double oldObj = sol.objective;
-                evaluateSolution(sol);
-                
-                if (sol.objective > oldObj) {
-                    improved = true;
-                } else {
-                    reverse(sol.tour.begin() + i, sol.tour.begin() + j + 1);
-                    sol.objective = oldObj;
-                }
-            }
-        }
-        return improved;
-    }
-    
-    // Or-Opt: mueve segmentos de 1, 2, o 3 ciudades
-    bool improveOrOpt(TTPSolution& sol, int maxSegmentSize = 3) {
-        bool improved = false;
-        int n = sol.tour.size();
-        
-        for (int segSize = 1; segSize <= maxSegmentSize; segSize++) {
-            for (int i = 1; i < n - segSize; i++) {
-                vector<int> segment(sol.tour.begin() + i, sol.tour.begin() + i + segSize);
-                
-                for (int j = 1; j < n - segSize; j++) {
-                    if (j >= i && j < i + segSize) continue;
-                    
-                    vector<int> newTour = sol.tour;
-                    newTour.erase(newTour.begin() + i, newTour.begin() + i + segSize);
-                    
-                    int insertPos = (j > i) ? j - segSize : j;
-                    newTour.insert(newTour.begin() + insertPos, segment.begin(), segment.end());
-                    
-                    double oldObj = sol.objective;
-                    vector<int> oldTour = sol.tour;
-                    
-                    sol.tour = newTour;
-                    evaluateSolution(sol);
-                    
-                    if (sol.objective > oldObj) {
-                        improved = true;
-                        goto next_segment;
-                    } else {
-                        sol.tour = oldTour;
-                        sol.objective = oldObj;
-                    }
-                }
-            }
-            next_segment:;
-        }
-        return improved;
-    }
-    
-    // Mejora híbrida: 2-Opt limitado + Or-Opt
+    // Mejora híbrida: 2-Opt + Or-Opt + Or-3opt con una sola cola de ciudades
+    // pendientes; tras cada ronda solo se vuelven a mirar las ciudades cuyos
+    // items cambiaron al rehacer el picking.
     void hybridImprovement(TTPSolution& sol, int maxIter = 3) {
-        for (int iter = 0; iter < maxIter; iter++) {
-            bool improved = false;
-            
-            if (improve2OptLimited(sol, 15)) {
-                improved = true;
-                sol.pickingPlan = createGreedyPickingPlan(sol.tour);
-                evaluateSolution(sol);
-            }
-            
-            if (improveOrOpt(sol, 2)) {
-                improved = true;
-                sol.pickingPlan = createGreedyPickingPlan(sol.tour);
-                evaluateSolution(sol);
-            }
+        work.dirty.fill(sol.tour);
+        for (int iter = 0; keepIterating(iter, maxIter); iter++) {
+            if (!improveTour(sol, TOUR_ALL, 15, 2, true)) break;
             
-            if (!improved) break;
+            work.previousPlan = sol.pickingPlan;
+            fillGreedyPickingPlan(sol.tour, sol.pickingPlan);
+            markChangedItems(work.previousPlan, sol.pickingPlan);
+            evaluateSolution(sol);
         }
     }
 
@@ -206,6 +150,10 @@ class LocalSearch2Opt : public OptimizedTTPHeuristic {
 public:
     LocalSearch2Opt(const TTPInstance& inst) : OptimizedTTPHeuristic(inst) {}
     
+    TTPHeuristic* clone() const override {
+        return new LocalSearch2Opt(*this);
+    }
+    
     string getName() const override {
         return "2-Opt Local Search + Greedy Picking";
     }
@@ -213,10 +161,12 @@ public:
     TTPSolution solve() override {
         TTPSolution sol;
         sol.tour = createNearestNeighborTour(0);
-        sol.pickingPlan = createGreedyPickingPlan(sol.tour);
+        fillGreedyPickingPlan(sol.tour, sol.pickingPlan);
         evaluateSolution(sol);
+        recordBest(sol);
         
         hybridImprovement(sol, 5);
+        recordBest(sol);
         
         return sol;
     }
@@ -227,53 +177,72 @@ class ProbabilisticNearestNeighbor2Opt : public OptimizedTTPHeuristic {
 private:
     double temperature;
     
+    // Solo se sortea entre los vecinos cercanos no visitados (fuera de ellos
+    // exp(-d/T) es despreciable); si ya están todos visitados se toma la
+    // ciudad no visitada más cercana con el árbol k-d.
     vector<int> createProbabilisticNearestNeighborTour(int start = 0) {
+        PhaseTimer timer(counters, PHASE_CONSTRUCTION);
         vector<int> tour;
         vector<bool> visited(instance.dimension, false);
+        KDTree tree(instance.distances);
+        int K = instance.num_candidates;
+        
+        vector<int> candidates;
+        vector<double> probabilities;
+        candidates.reserve(K);
+        probabilities.reserve(K);
         
         int current = start;
         tour.push_back(current);
         visited[current] = true;
+        tree.remove(current);
         
         for (int i = 1; i < instance.dimension; i++) {
-            vector<int> candidates;
-            vector<double> distances;
+            candidates.clear();
+            probabilities.clear();
             
-            for (int j = 0; j < instance.dimension; j++) {
-                if (!visited[j]) {
-                    candidates.push_back(j);
-                    distances.push_back(instance.distances[current][j]);
+            const int* near = &instance.candidates[(size_t)current * K];
+            for (int t = 0; t < K; t++) {
+                if (!visited[near[t]]) {
+                    candidates.push_back(near[t]);
                 }
             }
             
-            vector<double> probabilities;
-            double sumExp = 0.0;
-            
-            for (double dist : distances) {
-                double expValue = exp(-dist / temperature);
-                probabilities.push_back(expValue);
-                sumExp += expValue;
-            }
-            
-            for (double& prob : probabilities) {
-                prob /= sumExp;
-            }
-            
-            double randValue = ((double)rand() / RAND_MAX);
-            double cumulative = 0.0;
-            int selectedIdx = 0;
-            
-            for (int k = 0; k < probabilities.size(); k++) {
-                cumulative += probabilities[k];
-                if (randValue <= cumulative) {
-                    selectedIdx = k;
-                    break;
+            int nextCity;
+            if (candidates.empty()) {
+                nextCity = tree.nearestAlive(current);
+            } else {
+                // exp(-(d - dmin)/T): misma distribución que exp(-d/T) pero
+                // sin que todos los pesos se vuelvan 0 con distancias grandes
+                double minDist = instance.distances(current, candidates[0]);
+                for (int c : candidates) {
+                    minDist = min(minDist, instance.distances(current, c));
+                }
+                
+                double sumExp = 0.0;
+                for (int c : candidates) {
+                    double expValue = exp(-(instance.distances(current, c) - minDist) / temperature);
+                    probabilities.push_back(expValue);
+                    sumExp += expValue;
                 }
+                
+                double randValue = randomDouble() * sumExp;
+                double cumulative = 0.0;
+                int selectedIdx = 0;
+                
+                for (size_t k = 0; k < probabilities.size(); k++) {
+                    cumulative += probabilities[k];
+                    if (randValue <= cumulative) {
+                        selectedIdx = k;
+                        break;
+                    }
+                }
+                nextCity = candidates[selectedIdx];
             }
             
-            int nextCity = candidates[selectedIdx];
             tour.push_back(nextCity);
             visited[nextCity] = true;
+            tree.remove(nextCity);
             current = nextCity;
         }
         
@@ -282,8 +251,10 @@ private:
     
 public:
     ProbabilisticNearestNeighbor2Opt(const TTPInstance& inst, double temp = 0.5) 
-        : OptimizedTTPHeuristic(inst), temperature(temp) {
-        srand(time(0));
+        : OptimizedTTPHeuristic(inst), temperature(temp) {}
+    
+    TTPHeuristic* clone() const override {
+        return new ProbabilisticNearestNeighbor2Opt(*this);
     }
     
     string getName() const override {
@@ -294,14 +265,16 @@ public:
     TTPSolution solve() override {
         TTPSolution sol;
         sol.tour = createProbabilisticNearestNeighborTour(0);
-        sol.pickingPlan = createGreedyPickingPlan(sol.tour);
+        fillGreedyPickingPlan(sol.tour, sol.pickingPlan);
         evaluateSolution(sol);
+        recordBest(sol);
         
         int iterations = 0;
-        while (improve2OptLimited(sol, 15) && iterations < 100) {
+        while (improve2OptLimited(sol, 15) && keepIterating(iterations, 100)) {
             iterations++;
-            sol.pickingPlan = createGreedyPickingPlan(sol.tour);
+            fillGreedyPickingPlan(sol.tour, sol.pickingPlan);
             evaluateSolution(sol);
+            recordBest(sol);
         }
         
         return sol;
@@ -310,14 +283,92 @@ public:
 
 class BalancedTTPHeuristic : public TTPHeuristic {
 protected:
-    vector<int> createAdaptivePickingPlan(const vector<int>& tour, double fillRatio = 0.70) {
-        vector<int> pickingPlan(instance.num_items, 0);
+    // ---------- modelo de islas (LNS / VNS) ----------
+    // solve() con islands > 1 lanza una copia por isla en su propio hilo,
+    // cada una con su semilla y su ciudad de arranque para el tour inicial
+    // (con warm start todas parten de la solución cargada).
+    // Las islas forman un anillo: cada MIGRATION_INTERVAL iteraciones una
+    // isla envía su mejor solución a la siguiente por un buzón sin locks y
+    // adopta la que le llegó de la anterior si es mejor que la suya. Como
+    // los hilos avanzan a distinto ritmo, el resultado con más de una isla
+    // no es reproducible exactamente con la misma semilla.
+    typedef TripleBuffer<TTPSolution> Mailbox;
+    static const int MIGRATION_INTERVAL = 5;
+    
+    Mailbox* inbox;      // de la isla anterior (nullptr: búsqueda sola)
+    Mailbox* outbox;     // hacia la isla siguiente
+    int startCity;
+    double sentObjective;
+    
+    void migrate(int iter, TTPSolution& current, TTPSolution& best) {
+        if (!inbox || iter % MIGRATION_INTERVAL != 0) return;
+        
+        if (best.objective > sentObjective) {
+            outbox->writable() = best;
+            outbox->publish();
+            sentObjective = best.objective;
+        }
+        if (inbox->receive() && inbox->read().objective > best.objective) {
+            best = inbox->read();
+            current = best;
+            recordBest(best);
+        }
+    }
+    
+    TTPSolution solveIslands() {
+        int count = islands;
+        vector<unique_ptr<BalancedTTPHeuristic>> island(count);
+        vector<Mailbox> boxes(count);   // boxes[i]: de la isla i a la i + 1
+        for (int i = 0; i < count; i++) {
+            island[i].reset(static_cast<BalancedTTPHeuristic*>(clone()));
+            island[i]->islands = 1;
+            island[i]->setSeed(rng());
+            island[i]->startCity = (i == 0) ? 0 : randomInt(instance.dimension);
+            island[i]->inbox = &boxes[(i + count - 1) % count];
+            island[i]->outbox = &boxes[i];
+        }
+        
+        vector<TTPSolution> results(count);
+        vector<thread> threads;
+        for (int i = 0; i < count; i++) {
+            threads.emplace_back([&, i] { results[i] = island[i]->solve(); });
+        }
+        for (auto& t : threads) t.join();
+        
+        // mejor global y trayectoria conjunta (mejoras de cualquier isla)
+        int bestIsland = 0;
+        vector<pair<double, double>> points;
+        for (int i = 0; i < count; i++) {
+            if (results[i].objective > results[bestIsland].objective) bestIsland = i;
+            counters.addParallel(island[i]->getCounters());
+            const auto& t = island[i]->getTrajectory();
+            points.insert(points.end(), t.begin(), t.end());
+        }
+        sort(points.begin(), points.end());
+        for (auto& point : points) {
+            if (trajectory.empty() || point.second > trajectory.back().second) {
+                trajectory.push_back(point);
+            }
+        }
+        return results[bestIsland];
+    }
+    
+    PickingPlan createAdaptivePickingPlan(const vector<int>& tour, double fillRatio = 0.70) {
+        PickingPlan pickingPlan;
+        fillAdaptivePickingPlan(tour, fillRatio, pickingPlan);
+        return pickingPlan;
+    }
+    
+    // igual que createAdaptivePickingPlan pero escribiendo en un plan existente
+    void fillAdaptivePickingPlan(const vector<int>& tour, double fillRatio, PickingPlan& pickingPlan) {
+        PhaseTimer timer(counters, PHASE_PACKING);
+        pickingPlan.assign(instance.num_items);
     
         double distanciaTotal = 0;
         for (int i = 0; i < instance.dimension; i++) {
             int from = tour[i];
             int to = tour[(i + 1) % instance.dimension];
-            distanciaTotal += instance.distances[from][to];
+            distanciaTotal += instance.distances(from, to);
         }
         
         double tourFactor = 1.0;
@@ -327,27 +378,64 @@ protected:
         
         int capacidadObjetivo = min((int)(instance.capacity * fillRatio * tourFactor), instance.capacity);
         
-        vector<pair<double, int>> itemRatios;
-        for (int i = 0; i < instance.num_items; i++) {
-            double ratio = (double)instance.items[i].profit / instance.items[i].weight;
-            itemRatios.push_back({ratio, i});
-        }
-        sort(itemRatios.rbegin(), itemRatios.rend());
-        
         int currentWeight = 0;
-        for (auto& p : itemRatios) {
-            int itemIdx = p.second;
-            if (currentWeight + instance.items[itemIdx].weight <= capacidadObjetivo &&
-                currentWeight + instance.items[itemIdx].weight <= instance.capacity) {
-                pickingPlan[itemIdx] = 1;
-                currentWeight += instance.items[itemIdx].weight;
+        for (int itemIdx : instance.item_order) {
+            if (currentWeight + instance.item_weight[itemIdx] <= capacidadObjetivo &&
+                currentWeight + instance.item_weight[itemIdx] <= instance.capacity) {
+                pickingPlan.set(itemIdx);
+                currentWeight += instance.item_weight[itemIdx];
             }
         }
-        
-        return pickingPlan;
+    }
+    
+    static const int PARALLEL_SCAN_MIN_ITEMS = 4096;
+    
+    // Mejor flip (mayor flipDeltaFast > 0; con empate el de menor índice,
+    // igual que el barrido secuencial) repartiendo los items en bloques
+    // entre los hilos de searchPool. El evaluador y el plan solo se leen
+    // durante el barrido; cada bloque guarda su mejor y luego se reduce.
+    // Devuelve -1 si ningún flip mejora.
+    int bestFlipParallel(const PickingDeltaEvaluator& delta, const PickingPlan& plan) {
+        int m = instance.num_items;
+        int blocks = min(4 * searchPool.size(), m / 1024);
+        vector<pair<double, int>>& blockBest = work.blockBest;
+        vector<int>& blockTried = work.blockTried;
+        blockBest.assign(blocks, {0.0, -1});
+        blockTried.assign(blocks, 0);
+        
+        searchPool.get().parallelFor(blocks, [&](int b) {
+            double best = 0;
+            int bestItem = -1;
+            int tried = 0;
+            int end = (long)m * (b + 1) / blocks;
+            for (int i = (long)m * b / blocks; i < end; i++) {
+                if (delta.flipUpperBound(plan, i) <= best) continue;
+                tried++;
+                double improvement = delta.flipDeltaFast(plan, i);
+                if (improvement > best) {
+                    best = improvement;
+                    bestItem = i;
+                }
+            }
+            blockBest[b] = {best, bestItem};
+            blockTried[b] = tried;
+        });
+        for (int tried : blockTried) counters.tried[OP_FLIP] += tried;
+        
+        // los bloques están en orden de índice: ante empate gana el primero
+        int bestItem = -1;
+        double best = 0;
+        for (const pair<double, int>& candidate : blockBest) {
+            if (candidate.second != -1 && candidate.first > best) {
+                best = candidate.first;
+                bestItem = candidate.second;
+            }
+        }
+        return bestItem;
     }
     
     bool improvePickingWithObjective(TTPSolution& sol, int maxFlips = 50) {
+        PhaseTimer timer(counters, PHASE_PACKING);
         bool improved = false;
 
         if (!sol.isValid(instance)) {
@@ -355,45 +443,42 @@ protected:
             return false;
         }
         
+        PickingDeltaEvaluator& delta = work.picking;
+        delta.reset(sol.tour, sol.pickingPlan);
+        
         for (int flip = 0; flip < maxFlips; flip++) {
             int bestItem = -1;
             double bestImprovement = 0;
-            double currentObj = sol.objective;
             
-            for (int i = 0; i < instance.num_items; i++) {
-                int originalValue = sol.pickingPlan[i];
-                sol.pickingPlan[i] = 1 - sol.pickingPlan[i];
-                
-                evaluateSolution(sol);
-                
-                // CORRECCIÓN: Solo considerar si mejora Y es válida
-                if (sol.isValid(instance) && sol.objective > currentObj) {
-                    double improvement = sol.objective - currentObj;
+            if (searchPool.size() > 1 && instance.num_items >= PARALLEL_SCAN_MIN_ITEMS) {
+                if (timeUp()) break;
+                bestItem = bestFlipParallel(delta, sol.pickingPlan);
+            } else {
+                for (int i = 0; i < instance.num_items && !timeUp(); i++) {
+                    // descartar en O(1) los flips que no pueden superar al mejor
+                    if (delta.flipUpperBound(sol.pickingPlan, i) <= bestImprovement) continue;
+                    
+                    counters.tried[OP_FLIP]++;
+                    double improvement = delta.flipDeltaFast(sol.pickingPlan, i);
                     if (improvement > bestImprovement) {
                         bestImprovement = improvement;
                         bestItem = i;
                     }
                 }
-                
-                sol.pickingPlan[i] = originalValue;
             }
             
-            if (bestItem != -1) {
-                sol.pickingPlan[bestItem] = 1 - sol.pickingPlan[bestItem];
-                evaluateSolution(sol);
-                
-                // CORRECCIÓN CRÍTICA: verificar que sigue siendo válida después del cambio
-                if (!sol.isValid(instance)) {
-                    sol.pickingPlan[bestItem] = 1 - sol.pickingPlan[bestItem];
-                    evaluateSolution(sol);
-                    break;
-                }
+            // confirmar el mejor flip con la evaluación exacta antes de aplicarlo
+            if (bestItem != -1 && delta.flipDelta(sol.pickingPlan, bestItem) > 1e-9) {
+                delta.applyFlip(sol.pickingPlan, bestItem);
+                counters.accepted[OP_FLIP]++;
                 improved = true;
             } else {
                 break;
             }
         }
         
+        evaluateSolution(sol);
+        
         // CORRECCIÓN FINAL: asegurar que terminamos con solución válida
         if (!sol.isValid(instance)) {
             evaluateSolution(sol);
@@ -402,40 +487,24 @@ protected:
         return improved;
     }
     
-    bool improve2OptLimited(TTPSolution& sol, int maxNeighbors = 20) {
-        bool improved = false;
-        int n = sol.tour.size();
-        
-        for (int i = 1; i < n - 1; i++) {
-            int jMax = min(i + maxNeighbors, n);
-            
-            for (int j = i + 1; j < jMax; j++) {
-                reverse(sol.tour.begin() + i, sol.tour.begin() + j + 1);
-                
-                double oldObj = sol.objective;
-                evaluateSolution(sol);
-                
-                if (sol.objective > oldObj) {
-                    improved = true;
-                } else {
-                    reverse(sol.tour.begin() + i, sol.tour.begin() + j + 1);
-                    sol.objective = oldObj;
-                }
-            }
-        }
-        return improved;
-    }
-    
-    void jointImprovement(TTPSolution& sol, int maxIter = 3) {
-        for (int iter = 0; iter < maxIter; iter++) {
+    // Alterna la búsqueda local del tour (2-Opt, Or-Opt y Or-3opt) con la del
+    // picking. La cola de ciudades pendientes se conserva entre rondas: tras
+    // la primera solo se revisan las ciudades de los items invertidos y los
+    // extremos de las aristas que cambien a partir de ahí.
+    // Con seeded la primera ronda usa las ciudades que quien llama ya marcó.
+    void jointImprovement(TTPSolution& sol, int maxIter = 3, bool seeded = false) {
+        if (!seeded) work.dirty.fill(sol.tour);
+        for (int iter = 0; keepIterating(iter, maxIter); iter++) {
             bool improved = false;
             
-            if (improve2OptLimited(sol, 15)) {
+            if (improveTour(sol, TOUR_ALL, 15, 3, true)) {
                 improved = true;
             }
             
+            work.previousPlan = sol.pickingPlan;
             if (improvePickingWithObjective(sol, 20)) {
                 improved = true;
+                markChangedItems(work.previousPlan, sol.pickingPlan);
             }
             
             if (!improved) break;
@@ -443,24 +512,33 @@ protected:
     }
 
 public:
-    BalancedTTPHeuristic(const TTPInstance& inst) : TTPHeuristic(inst) {}
+    BalancedTTPHeuristic(const TTPInstance& inst)
+        : TTPHeuristic(inst), inbox(nullptr), outbox(nullptr), startCity(0),
+          sentObjective(-numeric_limits<double>::infinity()) {}
 };
 
 class ImprovedHillClimbing : public BalancedTTPHeuristic {
 public:
     ImprovedHillClimbing(const TTPInstance& inst) : BalancedTTPHeuristic(inst) {}
     
+    TTPHeuristic* clone() const override {
+        return new ImprovedHillClimbing(*this);
+    }
+    
     string getName() const override {
         return "Improved Hill Climbing (Adaptive Picking 75%)";
     }
     
     TTPSolution solve() override {
         TTPSolution sol;
-        sol.tour = createNearestNeighborTour(0);
-        sol.pickingPlan = createAdaptivePickingPlan(sol.tour, 0.75);
+        if (!initialTour(sol, [&] { return createNearestNeighborTour(0); })) {
+            fillAdaptivePickingPlan(sol.tour, 0.75, sol.pickingPlan);
+        }
         evaluateSolution(sol);
+        recordBest(sol);
         
         jointImprovement(sol, 5);
+        recordBest(sol);
         
         return sol;
     }
@@ -470,6 +548,10 @@ class Balanced2Opt : public BalancedTTPHeuristic {
 public:
     Balanced2Opt(const TTPInstance& inst) : BalancedTTPHeuristic(inst) {}
     
+    TTPHeuristic* clone() const override {
+        return new Balanced2Opt(*this);
+    }
+    
     string getName() const override {
         return "2-Opt + Balanced Picking (70%)";
     }
@@ -478,18 +560,52 @@ public:
         TTPSolution sol;
         sol.tour = createNearestNeighborTour(0);
         
-        sol.pickingPlan = createAdaptivePickingPlan(sol.tour, 0.70);
+        fillAdaptivePickingPlan(sol.tour, 0.70, sol.pickingPlan);
         evaluateSolution(sol);
+        recordBest(sol);
         
         // mejorar tour
         improve2OptLimited(sol, 20);
         
         // re-optimizar picking
-        sol.pickingPlan = createAdaptivePickingPlan(sol.tour, 0.70);
+        fillAdaptivePickingPlan(sol.tour, 0.70, sol.pickingPlan);
         evaluateSolution(sol);
         
         // mejora conjunta
         jointImprovement(sol, 5);
+        recordBest(sol);
+        
+        return sol;
+    }
+};
+
+// Tour base con Lin-Kernighan encadenado (solo distancia), picking según
+// el tour con PackIterative y luego la mejora conjunta tour/picking
+class LinKernighanPacking : public BalancedTTPHeuristic {
+private:
+    int kicks;
+
+public:
+    LinKernighanPacking(const TTPInstance& inst, int numKicks = -1)
+        : BalancedTTPHeuristic(inst), kicks(numKicks) {}
+    
+    TTPHeuristic* clone() const override {
+        return new LinKernighanPacking(*this);
+    }
+    
+    string getName() const override {
+        return "Chained LK + PackIterative";
+    }
+    
+    TTPSolution solve() override {
+        TTPSolution sol;
+        sol.tour = createLinKernighanTour(0, kicks);
+        fillPackedPickingPlan(sol.tour, sol.pickingPlan);
+        evaluateSolution(sol);
+        recordBest(sol);
+        
+        jointImprovement(sol, 5);
+        recordBest(sol);
         
         return sol;
     }
@@ -500,32 +616,75 @@ private:
     int destroySize;
     int maxIterations;
     
-    vector<int> destroyTour(const vector<int>& tour, int k) {
-        vector<int> removed;
-        vector<int> partial = tour;
-        
-        for (int i = 0; i < k; i++) {
-            if (partial.size() <= 1) break;
-            int idx = 1 + rand() % (partial.size() - 1);
-            removed.push_back(partial[idx]);
-            partial.erase(partial.begin() + idx);
+    // buffers del destroy/repair, reutilizados entre iteraciones
+    vector<int> removed;
+    vector<int> partial;
+    vector<char> isRemoved;   // por ciudad
+    vector<int> fenwick;      // árbol de Fenwick sobre las posiciones 1..n-1 del tour
+    
+    // Quita k ciudades al azar (nunca tour[0]) y deja el resto en 'partial'
+    // en su orden. Elige lo mismo que borrar k veces de una copia del tour la
+    // posición 1 + randomInt(tamaño - 1), pero buscando la idx-ésima posición
+    // que sigue presente con el árbol de Fenwick: O(n + k log n) en total.
+    void destroyTour(const vector<int>& tour, int k) {
+        int n = tour.size();
+        int positions = n - 1;
+        
+        fenwick.assign(n, 1);
+        for (int i = 1; i <= positions; i++) {
+            int parent = i + (i & -i);
+            if (parent <= positions) fenwick[parent] += fenwick[i];
+        }
+        int highBit = 1;
+        while (highBit * 2 <= positions) highBit *= 2;
+        
+        removed.clear();
+        isRemoved.assign(instance.dimension, 0);
+        int alive = positions;
+        for (int i = 0; i < k && alive > 0; i++) {
+            int target = 1 + randomInt(alive);
+            
+            int pos = 0;
+            for (int step = highBit; step > 0; step >>= 1) {
+                if (pos + step <= positions && fenwick[pos + step] < target) {
+                    pos += step;
+                    target -= fenwick[pos];
+                }
+            }
+            pos++;
+            
+            removed.push_back(tour[pos]);
+            isRemoved[tour[pos]] = 1;
+            for (int j = pos; j <= positions; j += j & -j) fenwick[j]--;
+            alive--;
         }
         
-        return removed;
+        partial.clear();
+        for (int city : tour) {
+            if (!isRemoved[city]) partial.push_back(city);
+        }
     }
     
-    vector<int> reconstructTour(vector<int> partial, const vector<int>& removed) {
+    // Inserción más barata de cada ciudad quitada, en orden, sobre 'partial'.
+    // partial tiene capacidad para el tour completo, así que insertar solo
+    // desplaza elementos y no pide memoria. Cada ciudad recorre todo el tour:
+    // la reparación es O(k·n), no O(n). Limitar la búsqueda a las aristas de
+    // las K vecinas más cercanas dejaba ~4% de las inserciones lejos de la
+    // mejor y bajaba el objetivo de LNS un 3-6% en rl1304, sin ganar tiempo
+    // medible (lo que domina cada iteración es el picking).
+    void reconstructTour() {
         for (int city : removed) {
             int bestPos = 1;
             double bestCost = numeric_limits<double>::infinity();
+            int size = partial.size();
             
-            for (int pos = 1; pos < partial.size(); pos++) {
+            for (int pos = 1; pos < size; pos++) {
                 int prev = partial[pos - 1];
                 int next = partial[pos];
                 
-                double cost = instance.distances[prev][city] + 
-                             instance.distances[city][next] -
-                             instance.distances[prev][next];
+                double cost = instance.distances(prev, city) + 
+                             instance.distances(city, next) -
+                             instance.distances(prev, next);
                 
                 if (cost < bestCost) {
                     bestCost = cost;
@@ -535,14 +694,14 @@ private:
             
             partial.insert(partial.begin() + bestPos, city);
         }
-        
-        return partial;
     }
 
 public:
     BalancedLNS(const TTPInstance& inst, int k = 10, int maxIter = 30) 
-        : BalancedTTPHeuristic(inst), destroySize(k), maxIterations(maxIter) {
-        srand(time(0));
+        : BalancedTTPHeuristic(inst), destroySize(k), maxIterations(maxIter) {}
+    
+    TTPHeuristic* clone() const override {
+        return new BalancedLNS(*this);
     }
     
     string getName() const override {
@@ -551,33 +710,46 @@ public:
     }
     
     TTPSolution solve() override {
+        if (islands > 1) return solveIslands();
+        
         TTPSolution best;
-        best.tour = createNearestNeighborTour(0);
-        best.pickingPlan = createAdaptivePickingPlan(best.tour, 0.70);
+        if (!initialTour(best, [&] { return createNearestNeighborTourFrom(startCity); })) {
+            fillPackedPickingPlan(best.tour, best.pickingPlan);
+        }
         evaluateSolution(best);
+        recordBest(best);
         
         TTPSolution current = best;
         int noImproveCount = 0;
         
-        for (int iter = 0; iter < maxIterations; iter++) {
-            vector<int> removed = destroyTour(current.tour, destroySize);
-            
-            vector<int> partial = current.tour;
-            for (int city : removed) {
-                auto it = find(partial.begin(), partial.end(), city);
-                if (it != partial.end()) {
-                    partial.erase(it);
-                }
+        partial.reserve(instance.dimension);
+        removed.reserve(destroySize);
+        
+        for (int iter = 0; keepIterating(iter, maxIterations); iter++) {
+            {
+                PhaseTimer timer(counters, PHASE_CONSTRUCTION);
+                destroyTour(current.tour, destroySize);
+                reconstructTour();
             }
             
-            current.tour = reconstructTour(partial, removed);
-            current.pickingPlan = createAdaptivePickingPlan(current.tour, 0.70);
+            // el tour viejo queda como buffer de la siguiente reconstrucción
+            current.tour.swap(partial);
+            work.previousPlan = current.pickingPlan;
+            fillPackedPickingPlan(current.tour, current.pickingPlan);
             evaluateSolution(current);
             
-            jointImprovement(current, 2);
+            // solo se revisan las ciudades reinsertadas, sus vecinas en el
+            // tour y las de los items que cambiaron
+            work.dirty.clear(instance.dimension);
+            for (int p = 1; p < (int)current.tour.size(); p++) {
+                if (isRemoved[current.tour[p]]) markAround(current.tour, p);
+            }
+            markChangedItems(work.previousPlan, current.pickingPlan);
+            jointImprovement(current, 2, true);
             
             if (current.objective > best.objective) {
                 best = current;
+                recordBest(best);
                 noImproveCount = 0;
             } else {
                 noImproveCount++;
@@ -586,6 +758,8 @@ public:
                     noImproveCount = 0;
                 }
             }
+            
+            migrate(iter, current, best);
         }
         
         return best;
@@ -599,16 +773,20 @@ private:
     
     void shaking(TTPSolution& sol, int k) {
         for (int i = 0; i < k; i++) {
-            int pos1 = 1 + rand() % (sol.tour.size() - 1);
-            int pos2 = 1 + rand() % (sol.tour.size() - 1);
+            int pos1 = 1 + randomInt(sol.tour.size() - 1);
+            int pos2 = 1 + randomInt(sol.tour.size() - 1);
             swap(sol.tour[pos1], sol.tour[pos2]);
+            markAround(sol.tour, pos1);
+            markAround(sol.tour, pos2);
         }
     }
 
 public:
     BalancedVNS(const TTPInstance& inst, int maxIter = 50, int k_max = 5)
-        : BalancedTTPHeuristic(inst), maxIterations(maxIter), kmax(k_max) {
-        srand(time(0));
+        : BalancedTTPHeuristic(inst), maxIterations(maxIter), kmax(k_max) {}
+    
+    TTPHeuristic* clone() const override {
+        return new BalancedVNS(*this);
     }
     
     string getName() const override {
@@ -617,26 +795,35 @@ public:
     }
     
     TTPSolution solve() override {
+        if (islands > 1) return solveIslands();
+        
         TTPSolution best;
-        best.tour = createNearestNeighborTour(0);
-        best.pickingPlan = createAdaptivePickingPlan(best.tour, 0.70);
+        if (!initialTour(best, [&] { return createNearestNeighborTourFrom(startCity); })) {
+            fillPackedPickingPlan(best.tour, best.pickingPlan);
+        }
         evaluateSolution(best);
+        recordBest(best);
         
         int iter = 0;
         int k = 1;
         int noImproveCount = 0;
         
-        while (iter < maxIterations) {
-            TTPSolution current = best;
+        TTPSolution current;
+        while (keepIterating(iter, maxIterations)) {
+            current = best;
             
+            work.dirty.clear(instance.dimension);
             shaking(current, k);
-            current.pickingPlan = createAdaptivePickingPlan(current.tour, 0.70);
+            work.previousPlan = current.pickingPlan;
+            fillPackedPickingPlan(current.tour, current.pickingPlan);
             evaluateSolution(current);
             
-            jointImprovement(current, 2);
+            markChangedItems(work.previousPlan, current.pickingPlan);
+            jointImprovement(current, 2, true);
             
             if (current.objective > best.objective) {
                 best = current;
+                recordBest(best);
                 k = 1;
                 noImproveCount = 0;
             } else {
@@ -644,9 +831,11 @@ public:
                 noImproveCount++;
                 
                 if (k > kmax) k = 1;
-                if (noImproveCount >= maxIterations / 4) break;
+                // con límite de tiempo se sigue sacudiendo hasta agotarlo
+                if (!deadline.isLimited() && noImproveCount >= maxIterations / 4) break;
             }
             
+            migrate(iter, current, best);
             iter++;
         }
         
@@ -0,0 +1,50 @@
+#ifndef TTP_ISLAND_H
+#define TTP_ISLAND_H
+
+#include <atomic>
+
+using namespace std;
+
+// ============================================================
+// BUZÓN SIN LOCKS ENTRE DOS ISLAS (TRIPLE BUFFER)
+// ============================================================
+// Un solo escritor y un solo lector. Hay tres copias del valor: una es del
+// escritor, otra del lector y la del medio se intercambia con un
+// exchange atómico, así que ninguno de los dos espera nunca al otro:
+//   - publish(): el escritor copia en la suya y la cambia por la del medio,
+//     marcándola como nueva
+//   - receive(): si la del medio es nueva, el lector la cambia por la suya
+//     y la lee; si no, devuelve false sin tocar nada
+// Si el escritor publica dos veces antes de que el lector mire, el lector
+// solo ve la última (es lo que interesa para migrar la mejor solución).
+template <typename T>
+class TripleBuffer {
+private:
+    static const int FRESH = 4;   // bit de "valor nuevo" junto al índice
+
+    T slots[3];
+    int back;                // índice del escritor
+    int front;               // índice del lector
+    atomic<int> middle;      // índice del medio | FRESH
+
+public:
+    TripleBuffer() : back(0), front(1), middle(2) {}
+
+    // el escritor prepara su copia con writable() y la publica
+    T& writable() { return slots[back]; }
+
+    void publish() {
+        back = middle.exchange(back | FRESH, memory_order_acq_rel) & 3;
+    }
+
+    bool receive() {
+        if (!(middle.load(memory_order_acquire) & FRESH)) return false;
+        front = middle.exchange(front, memory_order_acq_rel) & 3;
+        return true;
+    }
+
+    // último valor recibido
+    const T& read() const { return slots[front]; }
+};
+
+#endif
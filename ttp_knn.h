@@ -0,0 +1,182 @@
+#ifndef TTP_KNN_H
+#define TTP_KNN_H
+
+#include "ttp_distance.h"
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+using namespace std;
+
+// ============================================================
+// ÁRBOL K-D SOBRE LAS COORDENADAS DE LAS CIUDADES
+// ============================================================
+// Árbol implícito: el subárbol del rango [lo, hi) de 'order' tiene su raíz en
+// mid = (lo + hi) / 2, a la izquierda [lo, mid) y a la derecha [mid + 1, hi).
+// Además lleva la cuenta de ciudades "vivas" por subárbol, de modo que se
+// pueden ir quitando ciudades (las ya visitadas) y seguir preguntando por la
+// más cercana en O(log n) promedio.
+class KDTree {
+private:
+    const DistanceProvider& points;
+    int n;
+    vector<int> order;        // ciudades en el orden del árbol
+    vector<double> px, py;    // coordenadas en el orden del árbol
+    vector<int> where;        // posición de cada ciudad en 'order'
+    vector<char> splitAxis;   // eje de corte del nodo con raíz en cada posición
+    vector<int> aliveCount;   // ciudades vivas en el subárbol con raíz en cada posición
+    vector<char> removed;
+
+    double coord(int city, int axis) const {
+        return axis == 0 ? points.x(city) : points.y(city);
+    }
+
+    int build(int lo, int hi) {
+        if (lo >= hi) return 0;
+        int mid = (lo + hi) / 2;
+
+        double minX = numeric_limits<double>::infinity(), maxX = -minX;
+        double minY = minX, maxY = -minX;
+        for (int k = lo; k < hi; k++) {
+            minX = min(minX, points.x(order[k]));
+            maxX = max(maxX, points.x(order[k]));
+            minY = min(minY, points.y(order[k]));
+            maxY = max(maxY, points.y(order[k]));
+        }
+        int axis = (maxX - minX >= maxY - minY) ? 0 : 1;
+
+        nth_element(order.begin() + lo, order.begin() + mid, order.begin() + hi,
+                    [&](int a, int b) {
+                        double ca = coord(a, axis), cb = coord(b, axis);
+                        return ca < cb || (ca == cb && a < b);
+                    });
+        splitAxis[mid] = axis;
+        aliveCount[mid] = hi - lo;
+        build(lo, mid);
+        build(mid + 1, hi);
+        return hi - lo;
+    }
+
+    // más cercana viva por (distancia CEIL_2D, índice)
+    void nearest(int lo, int hi, int query, double& bestDist, int& best) const {
+        if (lo >= hi) return;
+        int mid = (lo + hi) / 2;
+        if (aliveCount[mid] == 0) return;
+
+        int city = order[mid];
+        if (!removed[city] && city != query) {
+            double d = points(query, city);
+            if (d < bestDist || (d == bestDist && city < best)) {
+                bestDist = d;
+                best = city;
+            }
+        }
+
+        int axis = splitAxis[mid];
+        double diff = coord(query, axis) - coord(city, axis);
+        bool goLeft = diff < 0 || (diff == 0 && query < city);
+        if (goLeft) nearest(lo, mid, query, bestDist, best);
+        else nearest(mid + 1, hi, query, bestDist, best);
+
+        // el otro lado está al menos a |diff|; con empate hay que mirar
+        // igual porque puede tener un índice menor
+        if (ceil(fabs(diff)) <= bestDist) {
+            if (goLeft) nearest(mid + 1, hi, query, bestDist, best);
+            else nearest(lo, mid, query, bestDist, best);
+        }
+    }
+
+    // k más cercanas por distancia euclídea (sin contar la propia ciudad),
+    // guardadas de menor a mayor en (bestSq, bestIdx)
+    void kNearest(int lo, int hi, int query, double qx, double qy, int k,
+                  vector<double>& bestSq, vector<int>& bestIdx) const {
+        if (lo >= hi) return;
+        int mid = (lo + hi) / 2;
+        int city = order[mid];
+
+        if (city != query) {
+            double dx = qx - px[mid];
+            double dy = qy - py[mid];
+            double sq = dx * dx + dy * dy;
+            int count = bestIdx.size();
+            if (count < k || sq < bestSq.back() || (sq == bestSq.back() && city < bestIdx.back())) {
+                if (count == k) {
+                    bestSq.pop_back();
+                    bestIdx.pop_back();
+                }
+                int p = bestIdx.size();
+                bestSq.push_back(sq);
+                bestIdx.push_back(city);
+                while (p > 0 && (bestSq[p - 1] > sq || (bestSq[p - 1] == sq && bestIdx[p - 1] > city))) {
+                    bestSq[p] = bestSq[p - 1];
+                    bestIdx[p] = bestIdx[p - 1];
+                    p--;
+                }
+                bestSq[p] = sq;
+                bestIdx[p] = city;
+            }
+        }
+
+        double diff = splitAxis[mid] == 0 ? qx - px[mid] : qy - py[mid];
+        bool goLeft = diff < 0;
+        if (goLeft) kNearest(lo, mid, query, qx, qy, k, bestSq, bestIdx);
+        else kNearest(mid + 1, hi, query, qx, qy, k, bestSq, bestIdx);
+
+        if ((int)bestIdx.size() < k || diff * diff <= bestSq.back()) {
+            if (goLeft) kNearest(mid + 1, hi, query, qx, qy, k, bestSq, bestIdx);
+            else kNearest(lo, mid, query, qx, qy, k, bestSq, bestIdx);
+        }
+    }
+
+public:
+    KDTree(const DistanceProvider& pts)
+        : points(pts), n(pts.size()), order(n), where(n),
+          splitAxis(n, 0), aliveCount(n, 0), removed(n, 0) {
+        for (int i = 0; i < n; i++) order[i] = i;
+        build(0, n);
+        px.resize(n);
+        py.resize(n);
+        for (int k = 0; k < n; k++) {
+            where[order[k]] = k;
+            px[k] = points.x(order[k]);
+            py[k] = points.y(order[k]);
+        }
+    }
+
+    // quitar una ciudad de las consultas de nearestAlive, en O(log n)
+    void remove(int city) {
+        if (removed[city]) return;
+        removed[city] = 1;
+
+        int target = where[city];
+        int lo = 0, hi = n;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            aliveCount[mid]--;
+            if (target == mid) break;
+            if (target < mid) hi = mid;
+            else lo = mid + 1;
+        }
+    }
+
+    // ciudad viva más cercana a 'query' (la misma que elegiría un barrido
+    // lineal por distancia con desempate por menor índice); -1 si no quedan
+    int nearestAlive(int query) const {
+        double bestDist = numeric_limits<double>::infinity();
+        int best = -1;
+        nearest(0, n, query, bestDist, best);
+        return best;
+    }
+
+    // las k ciudades más cercanas a 'query', de la más cercana a la más lejana
+    void kNearest(int query, int k, vector<int>& result) const {
+        vector<double> bestSq;
+        result.clear();
+        bestSq.reserve(k + 1);
+        result.reserve(k + 1);
+        kNearest(0, n, query, points.x(query), points.y(query), k, bestSq, result);
+    }
+};
+
+#endif
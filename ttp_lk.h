@@ -0,0 +1,267 @@
+#ifndef TTP_LK_H
+#define TTP_LK_H
+
+#include "reader.cpp"
+#include "ttp_dontlook.h"
+#include "ttp_rng.h"
+#include "ttp_timer.h"
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+// ============================================================
+// OPTIMIZADOR DE TOUR ESTILO LIN-KERNIGHAN (SOLO DISTANCIA)
+// ============================================================
+// Componente TSP: mejora el largo del ciclo sin mirar los items, para tener
+// un buen tour base antes de decidir el picking.
+//
+// Cada paso de LK desde t1 (con t2 su sucesor) elige t3 entre los vecinos
+// cercanos de t2 con ganancia parcial positiva, t4 el predecesor de t3, e
+// invierte el camino t2..t4: quedan las aristas (t2, t3) y (t1, t4), y t4
+// pasa a ser el nuevo sucesor de t1, así que la cadena sigue igual desde
+// ahí (movimientos 2-opt encadenados). Hasta maxDepth pasos; al final se
+// deshacen las inversiones posteriores al mejor cierre. Lo mismo en el otro
+// sentido con t2 el predecesor. Las ciudades a revisar salen de una cola
+// con don't-look bits.
+//
+// En modo encadenado (chained LK) se aplica una "patada" Or-opt: un tramo
+// al azar de hasta 50 ciudades se mueve junto a un vecino cercano de una
+// ciudad; LK repara alrededor y, si el tour no quedó más corto, se
+// deshacen todas las inversiones desde la patada.
+//
+// El tour es un arreglo cíclico con la posición de cada ciudad; cada
+// inversión recorre el lado más corto del ciclo.
+class LinKernighan {
+private:
+    struct Step {
+        double score;   // ganancia acumulada tras quitar (t3, t4)
+        int t3, t4;
+    };
+
+    struct Flip {
+        int from, to;   // posiciones invertidas (cíclicas, de from a to)
+        double delta;   // cambio del largo
+    };
+
+    const TTPInstance& instance;
+    int maxNeighbors;
+    int maxDepth;
+    int breadth;
+
+    int n;
+    vector<int> tour;
+    vector<int> position;
+    double length;
+    DirtyQueue dirty;
+    vector<Flip> journal;            // inversiones aplicadas, para deshacerlas
+    vector<pair<int, int>> added;    // aristas agregadas en la cadena actual
+    vector<int> touched;             // ciudades de las inversiones de la cadena
+    vector<Step> steps, firstSteps;
+
+    double d(int a, int b) const { return instance.distances(a, b); }
+    int next(int c) const { int p = position[c] + 1; return tour[p == n ? 0 : p]; }
+    int prev(int c) const { int p = position[c]; return tour[p == 0 ? n - 1 : p - 1]; }
+
+    // invertir las posiciones from..to (cíclicas), sin tocar el diario
+    void reversePositions(int from, int to) {
+        int len = to - from;
+        if (len < 0) len += n;
+        len++;
+        for (int k = 0; k < len / 2; k++) {
+            int a = from + k, b = to - k;
+            if (a >= n) a -= n;
+            if (b < 0) b += n;
+            swap(tour[a], tour[b]);
+            position[tour[a]] = a;
+            position[tour[b]] = b;
+        }
+    }
+
+    // invertir el camino a..b (en el sentido del tour): quedan las aristas
+    // (prev(a), b) y (a, next(b)). Como el ciclo no tiene sentido, se invierte
+    // el complemento si es más corto.
+    void flip(int a, int b) {
+        int pa = prev(a), nb = next(b);
+        double delta = d(pa, b) + d(a, nb) - d(pa, a) - d(b, nb);
+        int from = position[a], to = position[b];
+        int len = to - from;
+        if (len < 0) len += n;
+        if (2 * (len + 1) > n) {
+            from = position[nb];
+            to = position[pa];
+        }
+        reversePositions(from, to);
+        journal.push_back({from, to, delta});
+        length += delta;
+    }
+
+    void undoTo(size_t mark) {
+        while (journal.size() > mark) {
+            const Flip& f = journal.back();
+            reversePositions(f.from, f.to);
+            length -= f.delta;
+            journal.pop_back();
+        }
+    }
+
+    bool wasAdded(int a, int b) const {
+        for (const pair<int, int>& e : added) {
+            if ((e.first == a && e.second == b) || (e.first == b && e.second == a)) return true;
+        }
+        return false;
+    }
+
+    // Pasos posibles desde t2 con la ganancia acumulada 'gain', ordenados
+    // por ganancia parcial más la arista (t3, t4) que se quita.
+    void collectSteps(int t1, int t2, double gain, bool forward) {
+        int K = instance.num_candidates;
+        int numNeighbors = min(maxNeighbors, K);
+        steps.clear();
+        const int* near = &instance.candidates[(size_t)t2 * K];
+        for (int t = 0; t < numNeighbors; t++) {
+            int t3 = near[t];
+            double g1 = gain - d(t2, t3);
+            if (g1 <= 0) break;   // candidatos de menor a mayor distancia
+            if (t3 == t1) continue;
+            int t4 = forward ? prev(t3) : next(t3);
+            if (t4 == t2) continue;
+            if (wasAdded(t3, t4)) continue;
+            steps.push_back({g1 + d(t3, t4), t3, t4});
+        }
+        sort(steps.begin(), steps.end(), [](const Step& a, const Step& b) { return a.score > b.score; });
+    }
+
+    // Cadena LK desde t1; forward elige t2 = next(t1), si no prev(t1). En el
+    // primer paso se prueban hasta 'breadth' alternativas; después se sigue
+    // siempre por la mejor. Devuelve true si quedó aplicada una cadena que
+    // acorta el tour.
+    bool improveFrom(int t1, bool forward) {
+        size_t mark = journal.size();
+        int firstT2 = forward ? next(t1) : prev(t1);
+        collectSteps(t1, firstT2, d(t1, firstT2), forward);
+        firstSteps = steps;
+
+        for (int alt = 0; alt < breadth && alt < (int)firstSteps.size(); alt++) {
+            size_t bestMark = mark;
+            size_t bestTouched = 0;
+            double bestGain = 1e-9;
+            int t2 = firstT2;
+            added.clear();
+            touched.clear();
+
+            Step step = firstSteps[alt];
+            for (int depth = 0; depth < maxDepth; depth++) {
+                // invertir el complemento da vuelta el sentido de todo el ciclo
+                bool fwd = next(t1) == t2;
+                if (depth > 0) {
+                    collectSteps(t1, t2, step.score, fwd);
+                    if (steps.empty()) break;
+                    step = steps[0];
+                }
+
+                if (fwd) flip(t2, step.t4);
+                else flip(step.t4, t2);
+                added.push_back({t2, step.t3});
+                touched.push_back(t2);
+                touched.push_back(step.t3);
+                touched.push_back(step.t4);
+
+                t2 = step.t4;
+                double closed = step.score - d(t2, t1);
+                if (closed > bestGain) {
+                    bestGain = closed;
+                    bestMark = journal.size();
+                    bestTouched = touched.size();
+                }
+            }
+
+            // solo quedan pendientes los extremos de las inversiones conservadas
+            undoTo(bestMark);
+            for (size_t k = 0; k < bestTouched; k++) dirty.push(touched[k]);
+            if (bestMark > mark) return true;
+        }
+        return false;
+    }
+
+    // LK hasta vaciar la cola de ciudades pendientes
+    void runQueue(Deadline& deadline) {
+        while (!dirty.empty() && !deadline.expired()) {
+            int t1 = dirty.pop();
+            if (improveFrom(t1, true) || improveFrom(t1, false)) {
+                dirty.push(t1);
+            }
+        }
+    }
+
+    // patada Or-opt: mover el tramo que sigue a una ciudad al azar detrás
+    // de un vecino cercano de ella (fuera del tramo), con dos inversiones
+    bool kick(Xoshiro256& rng) {
+        int maxLen = min(50, n / 8);
+        if (maxLen < 1) return false;
+
+        int a = rng.nextInt(n);
+        int len = 1 + rng.nextInt(maxLen);
+        int K = instance.num_candidates;
+        int c = instance.candidates[(size_t)a * K + rng.nextInt(min(K, 5))];
+
+        // tramo S = next(a) .. last; c no debe estar en S ni ser su sucesor
+        int first = next(a);
+        int offset = position[c] - position[a];
+        if (offset < 0) offset += n;
+        if (offset <= len + 1) return false;
+        int last = tour[(position[a] + len) % n];
+        int after = next(last);
+        int nc = next(c);
+        if (nc == a) return false;
+
+        // a S after .. c nc  ->  a c .. after S^r nc  ->  a after .. c S^r nc
+        // (la segunda inversión según el sentido en que quedó el ciclo)
+        flip(first, c);
+        if (next(a) == c) flip(c, after);
+        else flip(after, c);
+        for (int city : {a, first, last, after, c, nc}) dirty.push(city);
+        return true;
+    }
+
+public:
+    LinKernighan(const TTPInstance& inst, int neighbors = 8, int depth = 10, int firstBreadth = 3)
+        : instance(inst), maxNeighbors(neighbors), maxDepth(depth), breadth(firstBreadth),
+          n(0), length(0) {}
+
+    // Mejora 'tour' (ciclo que empieza en tour[0], que se conserva como
+    // ciudad inicial) hasta un óptimo local de LK y luego aplica hasta
+    // 'kicks' patadas de LK encadenado, o las que quepan antes de 'deadline'.
+    // Devuelve el largo final del ciclo.
+    double optimize(vector<int>& t, int kicks, Xoshiro256& rng, Deadline& deadline) {
+        int start = t[0];
+        tour = t;
+        n = tour.size();
+        position.resize(instance.dimension);
+        length = 0;
+        for (int i = 0; i < n; i++) {
+            position[tour[i]] = i;
+            length += d(tour[i], tour[(i + 1) % n]);
+        }
+        if (n < 8) return length;
+
+        journal.clear();
+        dirty.fill(tour);
+        runQueue(deadline);
+
+        for (int k = 0; k < kicks && !deadline.expiredNow(); k++) {
+            journal.clear();
+            double before = length;
+            if (!kick(rng)) continue;
+            runQueue(deadline);
+            if (length > before - 1e-9) undoTo(0);
+        }
+
+        // volver a empezar en la ciudad inicial
+        int p = position[start];
+        for (int i = 0; i < n; i++) t[i] = tour[(p + i) % n];
+        return length;
+    }
+};
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef TTP_METRICS_H
+#define TTP_METRICS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <sys/resource.h>
+
+using namespace std;
+
+// ============================================================
+// CONTADORES DE UNA EJECUCIÓN
+// ============================================================
+// Cada heurística (y cada copia) tiene los suyos y los incrementa desde
+// los bucles de búsqueda sin sincronizar nada: un entero por evaluación
+// completa, por movimiento probado (el que llega a la evaluación TTP, no
+// los que descarta el filtro de distancia o la cota) y por movimiento
+// aplicado. El tiempo se reparte en tres fases con PhaseTimer. Los segundos
+// por fase son de pared: si una ejecución corre varias trayectorias en
+// paralelo (islas) se toma la más larga de cada fase, no la suma.
+
+enum SearchOperator {
+    OP_2OPT,
+    OP_OROPT,
+    OP_OR3OPT,
+    OP_FLIP,        // invertir un item del plan
+    NUM_OPERATORS
+};
+
+enum SearchPhase {
+    PHASE_CONSTRUCTION,   // construir tours (NN, aleatorio, reconstrucción de LNS)
+    PHASE_TOUR,           // búsqueda local del tour (2-Opt, Or-Opt, LK)
+    PHASE_PACKING,        // construir y mejorar el plan de recogida
+    NUM_PHASES
+};
+
+inline const char* operatorName(int op) {
+    switch (op) {
+        case OP_2OPT:   return "2opt";
+        case OP_OROPT:  return "oropt";
+        case OP_OR3OPT: return "or3opt";
+        default:        return "flip";
+    }
+}
+
+inline const char* phaseName(int phase) {
+    switch (phase) {
+        case PHASE_CONSTRUCTION: return "construccion";
+        case PHASE_TOUR:         return "tour";
+        default:                 return "picking";
+    }
+}
+
+struct SearchCounters {
+    uint64_t evaluations;
+    uint64_t tried[NUM_OPERATORS];
+    uint64_t accepted[NUM_OPERATORS];
+    double seconds[NUM_PHASES];
+    int activePhase;   // fase que se está midiendo (-1: ninguna)
+
+    SearchCounters() { clear(); }
+
+    void clear() {
+        evaluations = 0;
+        for (int op = 0; op < NUM_OPERATORS; op++) tried[op] = accepted[op] = 0;
+        for (int phase = 0; phase < NUM_PHASES; phase++) seconds[phase] = 0;
+        activePhase = -1;
+    }
+
+    void addCounts(const SearchCounters& other) {
+        evaluations += other.evaluations;
+        for (int op = 0; op < NUM_OPERATORS; op++) {
+            tried[op] += other.tried[op];
+            accepted[op] += other.accepted[op];
+        }
+    }
+
+    // suma de dos ejecuciones (o trayectorias) una después de la otra
+    void add(const SearchCounters& other) {
+        addCounts(other);
+        for (int phase = 0; phase < NUM_PHASES; phase++) seconds[phase] += other.seconds[phase];
+    }
+
+    // suma de una trayectoria que corrió en paralelo con esta: los
+    // contadores se suman y el tiempo de cada fase es el mayor
+    void addParallel(const SearchCounters& other) {
+        addCounts(other);
+        for (int phase = 0; phase < NUM_PHASES; phase++) seconds[phase] = max(seconds[phase], other.seconds[phase]);
+    }
+};
+
+// Suma a counters.seconds[phase] el tiempo hasta el final del bloque. Si ya
+// se está midiendo otra fase no hace nada: el tiempo queda en la de afuera
+// y nunca se cuenta dos veces.
+class PhaseTimer {
+private:
+    SearchCounters& counters;
+    int phase;
+    chrono::steady_clock::time_point start;
+
+public:
+    PhaseTimer(SearchCounters& c, SearchPhase p) : counters(c), phase(-1) {
+        if (counters.activePhase != -1) return;
+        phase = p;
+        counters.activePhase = p;
+        start = chrono::steady_clock::now();
+    }
+
+    ~PhaseTimer() {
+        if (phase == -1) return;
+        counters.seconds[phase] += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        counters.activePhase = -1;
+    }
+};
+
+// Memoria residente del proceso en KB. En Linux se lee de /proc/self/status
+// (VmHWM es el pico, VmRSS el valor actual); si no está disponible el pico
+// sale de getrusage, que no se puede reiniciar.
+inline long procStatusKB(const char* field) {
+    ifstream in("/proc/self/status");
+    string line;
+    size_t length = strlen(field);
+    while (getline(in, line)) {
+        if (line.compare(0, length, field) == 0) return atol(line.c_str() + length);
+    }
+    return -1;
+}
+
+inline long peakResidentKB() {
+    long kb = procStatusKB("VmHWM:");
+    if (kb >= 0) return kb;
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return usage.ru_maxrss;
+}
+
+// Vuelve a poner el pico (VmHWM) en la memoria actual, para medir el de una
+// sola ejecución. false si el sistema no lo permite.
+inline bool resetPeakResident() {
+    ofstream out("/proc/self/clear_refs");
+    out << "5" << flush;
+    return (bool)out;
+}
+
+#endif
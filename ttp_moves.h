@@ -0,0 +1,259 @@
+#ifndef TTP_MOVES_H
+#define TTP_MOVES_H
+
+#include "reader.cpp"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+// ============================================================
+// EVALUACIÓN DE MOVIMIENTOS DE TOUR (2-OPT / OR-OPT / OR-3OPT)
+// ============================================================
+// Con el plan de recogida fijo, un movimiento que solo reordena las ciudades
+// de las posiciones lo..hi deja igual el tiempo de las aristas anteriores y
+// también el de las posteriores (el conjunto de ciudades visitadas, y por
+// tanto el peso cargado, es el mismo al salir de la ventana). Guardando el
+// peso cargado y el tiempo acumulado por posición basta con recorrer la
+// ventana para obtener el cambio del objetivo, sin tocar el tour.
+//
+// Para Or-opt hay además una evaluación en O(1): mover un segmento de peso
+// w solo cambia en +-w el peso de las aristas que salta, y el tiempo de un
+// rango de aristas con el peso desplazado sale de sumas prefijas de
+// d / v^(t+1) (serie de Taylor de 1 / (v - nu * delta), como en
+// PickingDeltaEvaluator). Esas sumas se recalculan de forma perezosa: solo
+// cuando se pide un orOptDeltaFast después de aplicar un movimiento.
+class TourMoveEvaluator {
+private:
+    static const int TERMS = 10;
+
+    const TTPInstance& instance;
+    double nu;
+    int n;
+    bool feasible;
+
+    vector<int> position;        // posición de cada ciudad en el tour
+    vector<int> cityWeight;      // peso recogido en cada ciudad
+    vector<int> edgeWeight;      // peso cargado al recorrer la arista i
+    vector<double> edgeDist;     // largo de la arista i
+    vector<double> prefixTime;   // tiempo acumulado de las aristas 0..i-1
+
+    // termPrefix[t * (n + 1) + i] = suma de d_e / v_e^(t+1) para e < i,
+    // válido hasta la arista termsValidTo - 1
+    vector<double> termPrefix;
+    int termsValidTo;
+
+    double velocity(int w) const {
+        double v = instance.max_speed - nu * w;
+        return v < instance.min_speed ? instance.min_speed : v;
+    }
+
+    // cambio del tiempo si las posiciones lo..hi pasan a visitarse en el
+    // orden cityAt(0), ..., cityAt(hi - lo)
+    template <class CityAt>
+    double windowDelta(const vector<int>& tour, int lo, int hi, CityAt cityAt) const {
+        int prev = tour[lo - 1];
+        int carried = edgeWeight[lo - 1];
+        double newTime = 0.0;
+
+        for (int k = 0; k <= hi - lo; k++) {
+            int city = cityAt(k);
+            newTime += instance.distances(prev, city) / velocity(carried);
+            carried += cityWeight[city];
+            prev = city;
+        }
+        newTime += instance.distances(prev, tour[(hi + 1) % n]) / velocity(carried);
+
+        double oldTime = prefixTime[hi + 1] - prefixTime[lo - 1];
+        return -(newTime - oldTime) * instance.renting_ratio;
+    }
+
+    // recalcular pesos y tiempos a partir de la arista lo-1
+    void refreshFrom(const vector<int>& tour, int lo) {
+        for (int i = lo - 1; i < n; i++) {
+            int to = tour[(i + 1) % n];
+            position[tour[i]] = i;
+            edgeDist[i] = instance.distances(tour[i], to);
+            prefixTime[i + 1] = prefixTime[i] + edgeDist[i] / velocity(edgeWeight[i]);
+            if (i + 1 < n) edgeWeight[i + 1] = edgeWeight[i] + cityWeight[to];
+        }
+        termsValidTo = min(termsValidTo, lo - 1);
+    }
+
+    void updateTerms() {
+        for (int e = termsValidTo; e < n; e++) {
+            double inv = 1.0 / velocity(edgeWeight[e]);
+            double term = edgeDist[e] * inv;
+            for (int t = 0; t < TERMS; t++) {
+                size_t row = (size_t)t * (n + 1);
+                termPrefix[row + e + 1] = termPrefix[row + e] + term;
+                term *= inv;
+            }
+        }
+        termsValidTo = n;
+    }
+
+    // tiempo de las aristas a..b si el peso de cada una cambia en 'delta';
+    // false si la serie no converge lo bastante rápido
+    bool shiftedTime(int a, int b, int delta, double& time) const {
+        time = 0.0;
+        if (a > b) return true;
+
+        // los pesos crecen a lo largo del tour: la arista más lenta es b
+        double f = nu * delta;
+        if (fabs(f) > 0.15 * velocity(edgeWeight[b])) return false;
+
+        double power = 1.0;
+        for (int t = 0; t < TERMS; t++) {
+            size_t row = (size_t)t * (n + 1);
+            time += power * (termPrefix[row + b + 1] - termPrefix[row + a]);
+            power *= f;
+        }
+        return true;
+    }
+
+public:
+    TourMoveEvaluator(const TTPInstance& inst)
+        : instance(inst),
+          nu((inst.max_speed - inst.min_speed) / inst.capacity),
+          n(0), feasible(false) {}
+
+    void reset(const vector<int>& tour, const PickingPlan& pickingPlan) {
+        n = tour.size();
+        position.assign(instance.dimension, 0);
+
+        cityWeight.assign(instance.dimension, 0);
+        int total = 0;
+        pickingPlan.forEachSelected([&](int k) {
+            cityWeight[instance.item_node[k]] += instance.item_weight[k];
+            total += instance.item_weight[k];
+        });
+        feasible = total <= instance.capacity;
+
+        edgeWeight.assign(n, 0);
+        edgeDist.assign(n, 0.0);
+        prefixTime.assign(n + 1, 0.0);
+        termPrefix.assign((size_t)TERMS * (n + 1), 0.0);
+        termsValidTo = 0;
+        refreshFrom(tour, 1);
+    }
+
+    double getTime() const { return prefixTime[n]; }
+    int positionOf(int city) const { return position[city]; }
+
+    // invertir tour[i..j], con 1 <= i < j <= n-1
+    double twoOptDelta(const vector<int>& tour, int i, int j) const {
+        if (!feasible) return 0.0;
+        return windowDelta(tour, i, j, [&](int k) { return tour[j - k]; });
+    }
+
+    // mover el segmento tour[i..i+segSize-1] delante de la ciudad tour[j]
+    // (j == n lo deja al final del tour), con j fuera de [i, i+segSize];
+    // con reversed el segmento se inserta invertido (Or-3opt)
+    double orOptDelta(const vector<int>& tour, int i, int segSize, int j,
+                      bool reversed = false) const {
+        if (!feasible) return 0.0;
+        // r-ésima ciudad del segmento en su nuevo sentido
+        auto seg = [&](int r) { return reversed ? tour[i + segSize - 1 - r] : tour[i + r]; };
+        if (j > i) {
+            int insertPos = j - segSize;
+            return windowDelta(tour, i, j - 1, [&](int k) {
+                int q = i + k;
+                return q < insertPos ? tour[q + segSize] : seg(q - insertPos);
+            });
+        }
+        return windowDelta(tour, j, i + segSize - 1, [&](int k) {
+            int q = j + k;
+            return q < j + segSize ? seg(k) : tour[q - segSize];
+        });
+    }
+
+    // Igual que orOptDelta pero en O(TERMS + segSize): las aristas que el
+    // segmento salta se evalúan con el peso desplazado en -w (hacia
+    // adelante) o +w (hacia atrás) a partir de las sumas prefijas. Si la
+    // serie no converge se usa orOptDelta. Es una aproximación (error
+    // relativo ~0.15^TERMS): conviene confirmar con orOptDelta antes de
+    // aplicar el movimiento.
+    double orOptDeltaFast(const vector<int>& tour, int i, int segSize, int j,
+                          bool reversed = false) {
+        if (!feasible) return 0.0;
+        if (termsValidTo < n) updateTerms();
+
+        int first = tour[i];
+        int last = tour[i + segSize - 1];
+        int segWeight = 0;
+        for (int k = i; k < i + segSize; k++) segWeight += cityWeight[tour[k]];
+        if (reversed) swap(first, last);
+
+        // tiempo de las aristas internas del segmento (en su nuevo sentido)
+        // saliendo de la primera ciudad con 'carried' ya sumado su peso
+        auto segmentTime = [&](int& carried) {
+            double time = 0.0;
+            if (!reversed) {
+                for (int k = i; k < i + segSize - 1; k++) {
+                    carried += cityWeight[tour[k]];
+                    time += edgeDist[k] / velocity(carried);
+                }
+            } else {
+                for (int k = i + segSize - 1; k > i; k--) {
+                    carried += cityWeight[tour[k]];
+                    time += edgeDist[k - 1] / velocity(carried);
+                }
+            }
+            return time;
+        };
+
+        double newTime = 0.0, oldTime, shifted;
+        int carried;
+        if (j > i) {
+            // ... tour[i-1], tour[i+s..j-1], segmento, tour[j] ...
+            int after = tour[i + segSize];
+            int before = tour[j - 1];
+            if (!shiftedTime(i + segSize, j - 2, -segWeight, shifted)) {
+                return orOptDelta(tour, i, segSize, j, reversed);
+            }
+            newTime += instance.distances(tour[i - 1], after) / velocity(edgeWeight[i - 1]);
+            newTime += shifted;
+            carried = edgeWeight[j - 1] - segWeight;
+            newTime += instance.distances(before, first) / velocity(carried);
+            newTime += segmentTime(carried);
+            newTime += instance.distances(last, tour[j % n]) / velocity(edgeWeight[j - 1]);
+            oldTime = prefixTime[j] - prefixTime[i - 1];
+        } else {
+            // ... tour[j-1], segmento, tour[j..i-1], tour[i+s] ...
+            if (!shiftedTime(j, i - 2, segWeight, shifted)) {
+                return orOptDelta(tour, i, segSize, j, reversed);
+            }
+            carried = edgeWeight[j - 1];
+            newTime += instance.distances(tour[j - 1], first) / velocity(carried);
+            newTime += segmentTime(carried);
+            carried += cityWeight[last];
+            newTime += instance.distances(last, tour[j]) / velocity(carried);
+            newTime += shifted;
+            newTime += instance.distances(tour[i - 1], tour[(i + segSize) % n]) /
+                       velocity(edgeWeight[i + segSize - 1]);
+            oldTime = prefixTime[i + segSize] - prefixTime[j - 1];
+        }
+        return -(newTime - oldTime) * instance.renting_ratio;
+    }
+
+    void applyTwoOpt(vector<int>& tour, int i, int j) {
+        reverse(tour.begin() + i, tour.begin() + j + 1);
+        refreshFrom(tour, i);
+    }
+
+    void applyOrOpt(vector<int>& tour, int i, int segSize, int j, bool reversed = false) {
+        if (j > i) {
+            rotate(tour.begin() + i, tour.begin() + i + segSize, tour.begin() + j);
+            if (reversed) reverse(tour.begin() + j - segSize, tour.begin() + j);
+            refreshFrom(tour, i);
+        } else {
+            rotate(tour.begin() + j, tour.begin() + i, tour.begin() + i + segSize);
+            if (reversed) reverse(tour.begin() + j, tour.begin() + j + segSize);
+            refreshFrom(tour, j);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,273 @@
+#ifndef TTP_PACKING_H
+#define TTP_PACKING_H
+
+#include "reader.cpp"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+// ============================================================
+// EMPAQUETADO SEGÚN EL TOUR (estilo PackIterative)
+// ============================================================
+// Cada item recibe el puntaje  theta * log(profit / weight) - log(d), donde
+// d es la distancia que falta desde su ciudad hasta el final del tour (una
+// pasada de sumas de sufijos): un item que se recoge tarde cuesta poco
+// tiempo. Los items de la ciudad inicial no viajan (d = 0) y los de peso 0
+// no frenan: van primero, con el puntaje máximo. Los de ganancia 0 nunca
+// mejoran el objetivo y no se consideran.
+//
+// pack(theta) agrega los items por puntaje en lotes; tras cada lote evalúa
+// el objetivo y, si empeora, deshace el lote y lo reintenta con la mitad de
+// items (tras un lote aceptado el tamaño vuelve a duplicarse), hasta que un
+// solo item ya no mejora. Así se decide también cuánto llenar la mochila.
+// El tiempo del plan aceptado se guarda como sumas de prefijos por arista,
+// así que un lote solo recorre las aristas desde la primera posición que
+// toca: O(n - pos). Como el puntaje favorece los items del final del tour,
+// los lotes suelen tocar solo la cola. Un pack cuesta O(m log m) del orden
+// más O(n - pos) por lote; en el peor caso (lotes de un item al principio
+// del tour) se acerca a O(m·n).
+//
+// packIterative busca el exponente theta probando theta +- delta alrededor
+// del mejor y reduciendo delta a la mitad (1 + 2·rounds packs).
+// packTour decide cuánto buscar: si el tour cambió poco desde el último
+// que empaquetó (LNS y VNS cambian pocas aristas por iteración) parte del
+// theta anterior con un paso chico y en el sentido actual (5 packs); si no,
+// hace la búsqueda completa en los dos sentidos (34 packs).
+class PackingPlanner {
+private:
+    const TTPInstance& instance;
+    double nu;
+
+    vector<int> tour;
+    vector<int> position;       // posición de cada ciudad en el tour
+    vector<double> edgeDist;    // distancia de tour[i] a tour[i + 1]
+    vector<double> logRatio;    // log(profit / weight) de cada item
+    vector<double> logDist;     // log de la distancia restante desde cada posición
+
+    vector<pair<double, int>> scored;   // (puntaje, item) de los candidatos
+    vector<int> posWeight;              // peso recogido en cada posición (con el lote a prueba)
+    vector<int> carried;                // peso llevado por la arista i en el plan aceptado
+    vector<double> prefixTime;          // tiempo de las aristas 0..i-1 en el plan aceptado
+    vector<int> batch;
+    PickingPlan candidate;
+    PickingPlan reversedPlan;
+
+    // último tour empaquetado por packTour (sucesor de cada ciudad) y su theta
+    static const int WARM_ROUNDS = 2;
+    static constexpr double WARM_DELTA = 0.3125;
+    static constexpr double WARM_MAX_CHANGED = 0.1;   // fracción de aristas nuevas
+    bool warm;
+    double lastTheta;
+    vector<int> lastSucc;
+
+    double velocity(int w) const {
+        double v = instance.max_speed - nu * w;
+        return v < instance.min_speed ? instance.min_speed : v;
+    }
+
+    // Tiempo total con los pesos de posWeight, sabiendo que solo cambiaron
+    // las posiciones >= lo (lo >= 1: lo de la posición 0 no viaja). Suma en
+    // el mismo orden que un recorrido completo. Con commit = true el
+    // resultado pasa a ser el plan aceptado.
+    double travelTimeFrom(int lo, bool commit) {
+        int n = tour.size();
+        if (lo >= n) return prefixTime[n];
+        double time = prefixTime[lo];
+        int weight = carried[lo - 1];
+        for (int i = lo; i < n; i++) {
+            weight += posWeight[i];
+            time += edgeDist[i] / velocity(weight);
+            if (commit) {
+                carried[i] = weight;
+                prefixTime[i + 1] = time;
+            }
+        }
+        return time;
+    }
+
+    void setTour(const vector<int>& t) {
+        tour = t;
+        int n = tour.size();
+        position.resize(instance.dimension);
+        for (int i = 0; i < n; i++) position[tour[i]] = i;
+
+        edgeDist.resize(n);
+        for (int i = 0; i < n; i++) edgeDist[i] = instance.distances(tour[i], tour[(i + 1) % n]);
+
+        // distancia restante desde la posición i hasta volver a la inicial
+        // (la posición 0 no se usa: sus items tienen el puntaje máximo)
+        logDist.resize(n);
+        double remaining = 0;
+        for (int i = n - 1; i >= 1; i--) {
+            remaining += edgeDist[i];
+            logDist[i] = log(remaining);
+        }
+        logDist[0] = 0;
+    }
+
+    // plan con el exponente theta para el tour fijado por setTour; devuelve
+    // su objetivo
+    double pack(double theta, PickingPlan& plan) {
+        int n = tour.size();
+        int m = instance.num_items;
+        if ((int)logRatio.size() != m) {
+            logRatio.resize(m);
+            for (int k = 0; k < m; k++) {
+                // finito para ganancia y peso > 0, los únicos que se usan
+                logRatio[k] = (instance.item_profit[k] > 0 && instance.item_weight[k] > 0)
+                                  ? log(instance.item_ratio[k]) : 0;
+            }
+        }
+
+        // una distancia restante 0 da log(0) = -inf y puntaje +inf: se
+        // ordena igual que los demás (nunca NaN, logRatio es finito)
+        scored.clear();
+        for (int k = 0; k < m; k++) {
+            if (instance.item_weight[k] > instance.capacity || instance.item_profit[k] <= 0) continue;
+            int p = position[instance.item_node[k]];
+            double score = (p == 0 || instance.item_weight[k] == 0)
+                               ? numeric_limits<double>::max()
+                               : theta * logRatio[k] - logDist[p];
+            scored.push_back({score, k});
+        }
+        sort(scored.begin(), scored.end(), [](const pair<double, int>& a, const pair<double, int>& b) {
+            return a.first > b.first || (a.first == b.first && a.second < b.second);
+        });
+
+        plan.assign(m);
+        posWeight.assign(n, 0);
+        carried.assign(n, 0);
+        prefixTime.resize(n + 1);
+        prefixTime[0] = 0;
+        for (int i = 0; i < n; i++) prefixTime[i + 1] = prefixTime[i] + edgeDist[i] / velocity(0);
+        int weight = 0;
+        double profit = 0;
+        double best = -prefixTime[n] * instance.renting_ratio;
+
+        int count = scored.size();
+        int maxFreq = max(1, count / 16);
+        int freq = maxFreq;
+        int next = 0;
+        while (next < count) {
+            // siguiente lote: hasta freq items que aún caben
+            batch.clear();
+            int batchWeight = 0;
+            double batchProfit = 0;
+            int lo = n;   // primera posición (>= 1) que cambia de peso
+            int scan = next;
+            for (; scan < count && (int)batch.size() < freq; scan++) {
+                int k = scored[scan].second;
+                int w = instance.item_weight[k];
+                if (weight + batchWeight + w > instance.capacity) continue;
+                batch.push_back(k);
+                batchWeight += w;
+                batchProfit += instance.item_profit[k];
+                int p = position[instance.item_node[k]];
+                posWeight[p] += w;
+                if (p > 0) lo = min(lo, p);
+            }
+            if (batch.empty()) break;
+
+            double objective = profit + batchProfit - travelTimeFrom(lo, false) * instance.renting_ratio;
+            if (objective > best) {
+                travelTimeFrom(lo, true);
+                best = objective;
+                weight += batchWeight;
+                profit += batchProfit;
+                for (int k : batch) plan.set(k);
+                next = scan;
+                freq = min(freq * 2, maxFreq);
+            } else {
+                for (int k : batch) posWeight[position[instance.item_node[k]]] -= instance.item_weight[k];
+                if (freq == 1) break;
+                freq /= 2;
+            }
+        }
+        return best;
+    }
+
+    // aristas de t que no estaban en el último tour de packTour
+    int changedEdges(const vector<int>& t) const {
+        int n = t.size();
+        int changed = 0;
+        for (int i = 0; i < n; i++) {
+            int a = t[i], b = t[(i + 1) % n];
+            if (lastSucc[a] != b && lastSucc[b] != a) changed++;
+        }
+        return changed;
+    }
+
+public:
+    PackingPlanner(const TTPInstance& inst)
+        : instance(inst),
+          nu((inst.max_speed - inst.min_speed) / inst.capacity),
+          warm(false), lastTheta(5.0) {}
+
+    // búsqueda del exponente: empieza en theta y prueba theta +- delta
+    // 'rounds' veces, reduciendo delta a la mitad cada vez; el mejor queda
+    // en lastTheta
+    double packIterative(const vector<int>& t, PickingPlan& plan,
+                         double theta = 5.0, double delta = 2.5, int rounds = 8) {
+        setTour(t);
+
+        double best = pack(theta, plan);
+        for (int r = 0; r < rounds; r++) {
+            double bestTheta = theta;
+            for (double tryTheta : {theta - delta, theta + delta}) {
+                double objective = pack(tryTheta, candidate);
+                if (objective > best) {
+                    best = objective;
+                    bestTheta = tryTheta;
+                    swap(plan, candidate);
+                }
+            }
+            theta = bestTheta;
+            delta /= 2;
+        }
+        lastTheta = theta;
+        return best;
+    }
+
+    // Igual que packIterative, pero probando también el tour recorrido al
+    // revés (misma ciudad inicial): el sentido decide qué items se recogen
+    // tarde. Si el sentido inverso da mejor objetivo se invierte 't'.
+    double packBothDirections(vector<int>& t, PickingPlan& plan) {
+        double forward = packIterative(t, plan);
+        double forwardTheta = lastTheta;
+
+        reverse(t.begin() + 1, t.end());
+        double backward = packIterative(t, reversedPlan);
+        if (backward > forward) {
+            swap(plan, reversedPlan);
+            return backward;
+        }
+        reverse(t.begin() + 1, t.end());
+        lastTheta = forwardTheta;
+        return forward;
+    }
+
+    // Empaquetado de los tours de una búsqueda: si t comparte casi todas las
+    // aristas con el último tour empaquetado, busca theta cerca del anterior
+    // y solo en el sentido actual (el anterior ya eligió el sentido); si no,
+    // packBothDirections. Puede invertir t.
+    double packTour(vector<int>& t, PickingPlan& plan) {
+        int n = t.size();
+        double objective;
+        if (warm && (int)lastSucc.size() == instance.dimension &&
+            changedEdges(t) <= WARM_MAX_CHANGED * n) {
+            objective = packIterative(t, plan, lastTheta, WARM_DELTA, WARM_ROUNDS);
+        } else {
+            objective = packBothDirections(t, plan);
+        }
+
+        lastSucc.resize(instance.dimension);
+        for (int i = 0; i < n; i++) lastSucc[t[i]] = t[(i + 1) % n];
+        warm = true;
+        return objective;
+    }
+};
+
+#endif
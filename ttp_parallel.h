@@ -0,0 +1,176 @@
+#ifndef TTP_PARALLEL_H
+#define TTP_PARALLEL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <memory>
+
+using namespace std;
+
+// ============================================================
+// POOL DE HILOS
+// ============================================================
+// Hilos persistentes que reparten los trabajos de parallelFor con un
+// contador atómico. El hilo que llama también trabaja, así que un pool de
+// tamaño 1 no crea hilos y ejecuta todo en orden en el hilo actual.
+// parallelFor no es reentrante: un trabajo no debe llamar al mismo pool.
+class ThreadPool {
+private:
+    vector<thread> workers;
+    mutex mtx;
+    condition_variable wake;
+    condition_variable finished;
+
+    const function<void(int)>* task;
+    int numJobs;
+    atomic<int> nextJob;
+    int busyWorkers;
+    unsigned generation;
+    bool stopping;
+
+    void runJobs() {
+        for (;;) {
+            int job = nextJob.fetch_add(1);
+            if (job >= numJobs) break;
+            (*task)(job);
+        }
+    }
+
+    void workerLoop() {
+        unsigned seen = 0;
+        for (;;) {
+            {
+                unique_lock<mutex> lock(mtx);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+
+            runJobs();
+
+            lock_guard<mutex> lock(mtx);
+            if (--busyWorkers == 0) finished.notify_one();
+        }
+    }
+
+public:
+    explicit ThreadPool(int numThreads = 1)
+        : task(nullptr), numJobs(0), nextJob(0), busyWorkers(0),
+          generation(0), stopping(false) {
+        for (int i = 1; i < numThreads; i++) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    int size() const { return workers.size() + 1; }
+
+    // ejecutar job(0) ... job(n - 1) repartidos entre los hilos del pool
+    void parallelFor(int n, const function<void(int)>& job) {
+        if (workers.empty() || n <= 1) {
+            for (int i = 0; i < n; i++) job(i);
+            return;
+        }
+
+        {
+            lock_guard<mutex> lock(mtx);
+            task = &job;
+            numJobs = n;
+            nextJob.store(0);
+            busyWorkers = workers.size();
+            generation++;
+        }
+        wake.notify_all();
+
+        runJobs();
+
+        unique_lock<mutex> lock(mtx);
+        finished.wait(lock, [&] { return busyWorkers == 0; });
+        task = nullptr;
+    }
+};
+
+// Pool propio de un objeto que se copia (una heurística y sus clones): los
+// hilos se crean en el primer get() y una copia nunca comparte el pool del
+// original, solo su tamaño, porque parallelFor no es reentrante.
+class LazyThreadPool {
+private:
+    int threads;
+    unique_ptr<ThreadPool> pool;
+
+public:
+    explicit LazyThreadPool(int numThreads = 1) : threads(numThreads) {}
+    LazyThreadPool(const LazyThreadPool& other) : threads(other.threads) {}
+    LazyThreadPool& operator=(const LazyThreadPool& other) {
+        threads = other.threads;
+        pool.reset();
+        return *this;
+    }
+
+    void setThreads(int numThreads) {
+        if (numThreads != threads) {
+            threads = numThreads;
+            pool.reset();
+        }
+    }
+
+    int size() const { return threads; }
+
+    ThreadPool& get() {
+        if (!pool) pool.reset(new ThreadPool(threads));
+        return *pool;
+    }
+};
+
+// ============================================================
+// ORDENAMIENTO PARALELO
+// ============================================================
+// Ordena [first, last) en bloques, uno por hilo, y luego los mezcla por
+// pares con inplace_merge (también en paralelo). Con pocos elementos o un
+// solo hilo es un sort normal. El resultado es el mismo que el de sort para
+// cualquier comparador que sea un orden total.
+template <typename It, typename Compare>
+void parallelSort(It first, It last, Compare comp, int numThreads = thread::hardware_concurrency()) {
+    long n = last - first;
+    if (numThreads <= 1 || n < (1 << 15)) {
+        sort(first, last, comp);
+        return;
+    }
+    
+    int blocks = 1;
+    while (blocks * 2 <= numThreads) blocks *= 2;
+    vector<long> bounds(blocks + 1);
+    for (int b = 0; b <= blocks; b++) bounds[b] = n * b / blocks;
+    
+    vector<thread> threads;
+    for (int b = 0; b < blocks; b++) {
+        threads.emplace_back([&, b] { sort(first + bounds[b], first + bounds[b + 1], comp); });
+    }
+    for (auto& t : threads) t.join();
+    
+    for (int width = 1; width < blocks; width *= 2) {
+        threads.clear();
+        for (int b = 0; b + width < blocks; b += 2 * width) {
+            threads.emplace_back([&, b, width] {
+                inplace_merge(first + bounds[b], first + bounds[b + width],
+                              first + bounds[min(b + 2 * width, blocks)], comp);
+            });
+        }
+        for (auto& t : threads) t.join();
+    }
+}
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef TTP_PARSER_H
+#define TTP_PARSER_H
+
+#include <string>
+#include <cstring>
+#include <charconv>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+// ============================================================
+// ARCHIVO MAPEADO EN MEMORIA (solo lectura)
+// ============================================================
+class MappedFile {
+private:
+    const char* data;
+    size_t length;
+
+public:
+    MappedFile() : data(nullptr), length(0) {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (data && length > 0) munmap((void*)data, length);
+    }
+
+    bool open(const string& filename) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            return false;
+        }
+
+        length = st.st_size;
+        if (length > 0) {
+            void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+            if (p == MAP_FAILED) {
+                close(fd);
+                length = 0;
+                return false;
+            }
+            madvise(p, length, MADV_SEQUENTIAL);
+            data = (const char*)p;
+        }
+        close(fd);
+        return true;
+    }
+
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+    size_t size() const { return length; }
+};
+
+// ============================================================
+// LECTOR DE NÚMEROS SOBRE EL BUFFER
+// ============================================================
+// Recorre el buffer sin copiar líneas: los números se leen directamente con
+// from_chars y se lleva la cuenta de líneas para los mensajes de error.
+class TextScanner {
+private:
+    const char* cur;
+    const char* end;
+    int line;
+
+    static bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    void skipBlanks() {
+        while (cur < end && isBlank(*cur)) cur++;
+    }
+
+    // saltar espacios, incluidos los saltos de línea
+    void skipWhitespace() {
+        while (cur < end && (isBlank(*cur) || *cur == '\n')) {
+            if (*cur == '\n') line++;
+            cur++;
+        }
+    }
+
+public:
+    TextScanner(const char* begin, const char* finish)
+        : cur(begin), end(finish), line(1) {}
+
+    bool atEnd() const { return cur >= end; }
+    int lineNumber() const { return line; }
+
+    // la línea actual sin el salto de línea (ni el '\r' final)
+    const char* lineEnd() const {
+        const char* p = (const char*)memchr(cur, '\n', end - cur);
+        if (!p) p = end;
+        while (p > cur && p[-1] == '\r') p--;
+        return p;
+    }
+
+    const char* position() const { return cur; }
+
+    void nextLine() {
+        const char* p = (const char*)memchr(cur, '\n', end - cur);
+        if (!p) {
+            cur = end;
+            return;
+        }
+        cur = p + 1;
+        line++;
+    }
+
+    // ¿la línea actual empieza (tras espacios) por 'prefix'?
+    bool lineStartsWith(const char* prefix) {
+        skipBlanks();
+        size_t len = strlen(prefix);
+        return (size_t)(end - cur) >= len && memcmp(cur, prefix, len) == 0;
+    }
+
+    // enteros: lector propio, bastante más rápido que from_chars para los
+    // cientos de miles de números cortos de la sección de items
+    bool readNumber(int& value) {
+        long v;
+        if (!readNumber(v)) return false;
+        value = (int)v;
+        return true;
+    }
+
+    bool readNumber(long& value) {
+        skipWhitespace();
+        bool negative = false;
+        if (cur < end && (*cur == '-' || *cur == '+')) {
+            negative = *cur == '-';
+            cur++;
+        }
+        if (cur >= end || (unsigned)(*cur - '0') > 9) return false;
+
+        long v = 0;
+        while (cur < end && (unsigned)(*cur - '0') <= 9) {
+            v = v * 10 + (*cur - '0');
+            cur++;
+        }
+        value = negative ? -v : v;
+        return true;
+    }
+
+    bool readNumber(double& value) {
+        skipWhitespace();
+        if (cur < end && *cur == '+') cur++;
+        auto res = from_chars(cur, end, value);
+        if (res.ec != errc()) return false;
+        cur = res.ptr;
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef TTP_RNG_H
+#define TTP_RNG_H
+
+#include <cstdint>
+
+using namespace std;
+
+// ============================================================
+// GENERADORES ALEATORIOS REPRODUCIBLES
+// ============================================================
+
+// SplitMix64: mezcla un entero de 64 bits; sirve para derivar semillas y
+// para llenar el estado de xoshiro
+inline uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// semilla de la ejecución 'run' de la heurística 'heuristic' a partir de la
+// semilla maestra: la misma terna da siempre la misma trayectoria
+inline uint64_t deriveSeed(uint64_t master, uint64_t heuristic, uint64_t run) {
+    uint64_t state = master;
+    uint64_t h = splitMix64(state) ^ heuristic;
+    h = splitMix64(h) ^ run;
+    return splitMix64(h);
+}
+
+// xoshiro256**: rápido, 256 bits de estado y el mismo resultado en cualquier
+// plataforma (a diferencia de las distribuciones de <random> y de
+// std::shuffle, que dependen de la biblioteca estándar: para mezclar se usa
+// nextInt).
+class Xoshiro256 {
+private:
+    uint64_t s[4];
+
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+public:
+    typedef uint64_t result_type;
+
+    explicit Xoshiro256(uint64_t seed = 0) { seedWith(seed); }
+
+    void seedWith(uint64_t seed) {
+        uint64_t state = seed;
+        for (int i = 0; i < 4; i++) s[i] = splitMix64(state);
+    }
+
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return ~0ULL; }
+
+    uint64_t operator()() {
+        uint64_t result = rotl(s[1] * 5, 7) * 9;
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    // entero uniforme en [0, n) (método de Lemire, sin sesgo)
+    uint32_t nextInt(uint32_t n) {
+        uint64_t m = (uint64_t)(uint32_t)((*this)() >> 32) * n;
+        uint32_t low = (uint32_t)m;
+        if (low < n) {
+            uint32_t threshold = (0u - n) % n;
+            while (low < threshold) {
+                m = (uint64_t)(uint32_t)((*this)() >> 32) * n;
+                low = (uint32_t)m;
+            }
+        }
+        return m >> 32;
+    }
+
+    // real uniforme en [0, 1)
+    double nextDouble() {
+        return ((*this)() >> 11) * (1.0 / 9007199254740992.0);
+    }
+};
+
+#endif
@@ -0,0 +1,186 @@
+#ifndef TTP_SINK_H
+#define TTP_SINK_H
+
+#include "reader.cpp"
+#include "ttp_solution.h"
+#include <vector>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <sys/stat.h>
+
+using namespace std;
+
+// ============================================================
+// VOLCADO ASÍNCRONO DE LAS SOLUCIONES DE CADA EJECUCIÓN
+// ============================================================
+// Los hilos que resuelven llaman a submit() con la solución de cada
+// ejecución: solo se copia el registro a la cola bajo un mutex y se
+// despierta al hilo escritor, que formatea y escribe fuera del camino de
+// la búsqueda. El escritor toma la cola entera de una vez (intercambio de
+// vectores) y escribe el lote por un buffer grande. close() espera a que
+// todo esté en disco.
+//
+// En el directorio de salida quedan:
+//   - un archivo de texto por ejecución con el formato de solución de la
+//     competencia TTP (writeTTPSolutionText, en ttp_solution.h).
+//     Nombre: <instancia>__<heuristica>__run<k>.txt
+//   - solutions.bin con todas las ejecuciones en binario compacto (enteros
+//     y reales en el orden de bytes de la máquina):
+//       cabecera: "TTPSOL1\0"
+//       por ejecución: u32 largo + nombre de la instancia, u32 largo +
+//       nombre de la heurística, u32 run, u64 semilla, f64 objetivo,
+//       f64 ganancia, f64 tiempo, i32 peso, u32 n + n x i32 tour (desde 0),
+//       u32 m + ceil(m / 64) x u64 plan de recogida (bit i = item i)
+
+const char TTP_SOLUTION_MAGIC[8] = {'T', 'T', 'P', 'S', 'O', 'L', '1', '\0'};
+
+struct SolutionRecord {
+    string instance;     // etiqueta de la instancia (nombre del archivo sin .ttp)
+    string heuristic;
+    int run;             // desde 1
+    uint64_t seed;
+    TTPSolution solution;
+};
+
+class ResultSink {
+private:
+    static const size_t BUFFER_BYTES = 1 << 20;
+
+    string directory;
+    ofstream binary;
+    vector<char> binaryBuffer;
+
+    mutex mtx;
+    condition_variable pending;
+    vector<SolutionRecord> queue;
+    bool closing;
+    int failures;
+    thread writer;
+
+    template <typename T>
+    void put(const T& value) {
+        binary.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void putString(const string& text) {
+        put((uint32_t)text.size());
+        binary.write(text.data(), text.size());
+    }
+
+    void writeBinary(const SolutionRecord& r) {
+        const TTPSolution& sol = r.solution;
+        putString(r.instance);
+        putString(r.heuristic);
+        put((uint32_t)r.run);
+        put(r.seed);
+        put(sol.objective);
+        put(sol.profit);
+        put(sol.time);
+        put((int32_t)sol.weight);
+        put((uint32_t)sol.tour.size());
+        for (int city : sol.tour) put((int32_t)city);
+
+        int m = sol.pickingPlan.size();
+        put((uint32_t)m);
+        for (int w = 0; w < (m + 63) / 64; w++) {
+            uint64_t word = 0;
+            for (int b = 0; b < 64 && w * 64 + b < m; b++) {
+                if (sol.pickingPlan[w * 64 + b]) word |= 1ULL << b;
+            }
+            put(word);
+        }
+    }
+
+    bool writeText(const SolutionRecord& r) {
+        string path = directory + "/" + fileSlug(r.instance) + "__" + fileSlug(r.heuristic) +
+                      "__run" + to_string(r.run) + ".txt";
+        ofstream out(path);
+        if (!out) return false;
+        writeTTPSolutionText(out, r.solution);
+        return (bool)out;
+    }
+
+    void writerLoop() {
+        vector<SolutionRecord> batch;
+        for (;;) {
+            {
+                unique_lock<mutex> lock(mtx);
+                pending.wait(lock, [&] { return closing || !queue.empty(); });
+                if (queue.empty()) break;   // closing y nada pendiente
+                batch.swap(queue);
+            }
+
+            int failed = 0;
+            for (const SolutionRecord& r : batch) {
+                if (!writeText(r)) failed++;
+                writeBinary(r);
+            }
+            binary.flush();
+            if (!binary) failed++;
+            batch.clear();
+
+            if (failed) {
+                lock_guard<mutex> lock(mtx);
+                failures += failed;
+            }
+        }
+    }
+
+public:
+    ResultSink() : binaryBuffer(BUFFER_BYTES), closing(true), failures(0) {}
+
+    ~ResultSink() {
+        close();
+    }
+
+    // crear el directorio (si hace falta) y empezar a escribir
+    bool open(const string& dir) {
+        directory = dir;
+        mkdir(directory.c_str(), 0755);
+        binary.rdbuf()->pubsetbuf(binaryBuffer.data(), binaryBuffer.size());
+        binary.open(directory + "/solutions.bin", ios::binary | ios::trunc);
+        if (!binary) {
+            cerr << "Error: No se pudo escribir en el directorio de soluciones " << directory << endl;
+            return false;
+        }
+        binary.write(TTP_SOLUTION_MAGIC, sizeof(TTP_SOLUTION_MAGIC));
+        closing = false;
+        writer = thread([this] { writerLoop(); });
+        return true;
+    }
+
+    bool isOpen() const {
+        return writer.joinable();
+    }
+
+    void submit(SolutionRecord record) {
+        {
+            lock_guard<mutex> lock(mtx);
+            queue.push_back(move(record));
+        }
+        pending.notify_one();
+    }
+
+    // esperar a que se escriba todo lo enviado; false si algo falló
+    bool close() {
+        if (!writer.joinable()) return failures == 0;
+        {
+            lock_guard<mutex> lock(mtx);
+            closing = true;
+        }
+        pending.notify_one();
+        writer.join();
+        binary.close();
+        if (failures > 0) {
+            cerr << "Error: " << failures << " soluciones no se pudieron escribir en " << directory << endl;
+        }
+        return failures == 0;
+    }
+};
+
+#endif
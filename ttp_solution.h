@@ -0,0 +1,256 @@
+#ifndef TTP_SOLUTION_H
+#define TTP_SOLUTION_H
+
+#include "reader.cpp"
+#include "ttp_evaluator.h"
+#include <vector>
+#include <string>
+#include <map>
+#include <limits>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <dirent.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+struct TTPSolution {
+    vector<int> tour;       
+    PickingPlan pickingPlan;   
+    double objective;         
+    double profit;           
+    double time;              
+    int weight;                 
+    
+    TTPSolution() : objective(-numeric_limits<double>::infinity()), 
+                    profit(0), time(0), weight(0) {}
+    
+    bool isValid(const TTPInstance& inst) const {
+        return weight <= inst.capacity && tour.size() == (size_t)inst.dimension;
+    }
+};
+
+// ============================================================
+// ARCHIVOS DE SOLUCIÓN
+// ============================================================
+// Formato de la competencia TTP (GECCO): el tour como [c1,c2,...] con
+// ciudades desde 1, empezando en la ciudad inicial y sin repetirla, y en
+// la línea siguiente los items recogidos como [i1,i2,...] con los índices
+// de la ITEMS SECTION (desde 1).
+
+inline void writeTTPSolutionText(ostream& out, const TTPSolution& sol) {
+    out << "[";
+    for (size_t i = 0; i < sol.tour.size(); i++) {
+        out << (i ? "," : "") << sol.tour[i] + 1;
+    }
+    out << "]\n[";
+    bool first = true;
+    sol.pickingPlan.forEachSelected([&](int item) {
+        out << (first ? "" : ",") << item + 1;
+        first = false;
+    });
+    out << "]\n";
+}
+
+// nombre de archivo a partir de un texto libre: letras, dígitos, '-' y '.'
+// se conservan; cualquier otra secuencia queda como un '_'
+inline string fileSlug(const string& text) {
+    string slug;
+    for (char c : text) {
+        if (isalnum((unsigned char)c) || c == '-' || c == '.') {
+            slug += c;
+        } else if (!slug.empty() && slug.back() != '_') {
+            slug += '_';
+        }
+    }
+    while (!slug.empty() && slug.back() == '_') slug.pop_back();
+    return slug;
+}
+
+// etiqueta de una instancia: nombre del archivo sin directorio ni .ttp
+inline string instanceLabel(const string& filename) {
+    string label = filename.substr(filename.find_last_of('/') + 1);
+    if (label.size() > 4 && label.compare(label.size() - 4, 4, ".ttp") == 0) {
+        label.resize(label.size() - 4);
+    }
+    return label;
+}
+
+// enteros de text[from, to), separados por cualquier cosa que no sea dígito
+// o signo
+inline vector<long> parseIntegers(const string& text, size_t from, size_t to) {
+    vector<long> values;
+    const char* p = text.c_str() + from;
+    const char* end = text.c_str() + to;
+    while (p < end) {
+        if (isdigit((unsigned char)*p) || (*p == '-' && p + 1 < end && isdigit((unsigned char)p[1]))) {
+            char* next;
+            values.push_back(strtol(p, &next, 10));
+            p = next;
+        } else {
+            p++;
+        }
+    }
+    return values;
+}
+
+// Lee un tour o una solución y la valida contra la instancia. Acepta:
+//   - el formato de la competencia TTP: [tour] y opcionalmente [items]
+//   - un tour TSPLIB: los números después de TOUR_SECTION hasta -1
+//   - cualquier otro archivo: todos sus números forman el tour
+// Ciudades e items van desde 1. El tour debe pasar una vez por cada ciudad
+// y se rota para que empiece en la ciudad 1 (la inicial del TTP). withItems
+// dice si el archivo traía plan de recogida; si no, el plan queda vacío.
+// No evalúa la solución: objetivo, ganancia, tiempo y peso quedan sin
+// calcular.
+inline bool readSolutionFile(const string& filename, const TTPInstance& instance,
+                             TTPSolution& sol, bool& withItems) {
+    ifstream in(filename);
+    if (!in) {
+        cerr << "Error: No se pudo abrir el archivo de solucion " << filename << endl;
+        return false;
+    }
+    stringstream buffer;
+    buffer << in.rdbuf();
+    string text = buffer.str();
+
+    vector<long> cities, items;
+    withItems = false;
+    size_t open = text.find('[');
+    size_t section = text.find("TOUR_SECTION");
+    if (open != string::npos) {
+        size_t close = text.find(']', open);
+        if (close == string::npos) {
+            cerr << "Error: " << filename << ": falta ']' al final del tour" << endl;
+            return false;
+        }
+        cities = parseIntegers(text, open + 1, close);
+        size_t openItems = text.find('[', close);
+        if (openItems != string::npos) {
+            size_t closeItems = text.find(']', openItems);
+            if (closeItems == string::npos) {
+                cerr << "Error: " << filename << ": falta ']' al final de los items" << endl;
+                return false;
+            }
+            items = parseIntegers(text, openItems + 1, closeItems);
+            withItems = true;
+        }
+    } else if (section != string::npos) {
+        cities = parseIntegers(text, section, text.size());
+        size_t last = find(cities.begin(), cities.end(), -1L) - cities.begin();
+        cities.resize(last);
+    } else {
+        cities = parseIntegers(text, 0, text.size());
+    }
+
+    // tour: una permutación de 1..dimension
+    if ((int)cities.size() != instance.dimension) {
+        cerr << "Error: " << filename << ": el tour tiene " << cities.size() << " ciudades y la instancia "
+             << instance.dimension << endl;
+        return false;
+    }
+    vector<char> seen(instance.dimension, 0);
+    for (long city : cities) {
+        if (city < 1 || city > instance.dimension || seen[city - 1]) {
+            cerr << "Error: " << filename << ": ciudad " << city << " invalida o repetida en el tour" << endl;
+            return false;
+        }
+        seen[city - 1] = 1;
+    }
+    size_t depot = find(cities.begin(), cities.end(), 1L) - cities.begin();
+    sol.tour.resize(instance.dimension);
+    for (int i = 0; i < instance.dimension; i++) {
+        sol.tour[i] = cities[(depot + i) % cities.size()] - 1;
+    }
+
+    // items: índices de 1..num_items sin repetir y dentro de la capacidad
+    sol.pickingPlan.assign(instance.num_items);
+    long weight = 0;
+    for (long item : items) {
+        if (item < 1 || item > instance.num_items || sol.pickingPlan[item - 1]) {
+            cerr << "Error: " << filename << ": item " << item << " invalido o repetido" << endl;
+            return false;
+        }
+        sol.pickingPlan.set(item - 1);
+        weight += instance.item_weight[item - 1];
+    }
+    if (weight > instance.capacity) {
+        cerr << "Error: " << filename << ": los items pesan " << weight << " y la capacidad es "
+             << instance.capacity << endl;
+        return false;
+    }
+    return true;
+}
+
+// Índice de un directorio de --solutions: para cada instancia (fileSlug de
+// su etiqueta) las rutas de sus <etiqueta>__*.txt, ordenadas. fileSlug
+// nunca deja "__", así que la etiqueta es lo que está antes del primero.
+// Se lee el directorio una sola vez aunque se busquen muchas instancias.
+typedef map<string, vector<string>> SolutionIndex;
+
+inline bool indexSolutionDir(const string& dir, SolutionIndex& index) {
+    DIR* d = opendir(dir.c_str());
+    if (!d) {
+        cerr << "Error: No se pudo abrir el directorio " << dir << endl;
+        return false;
+    }
+    while (dirent* entry = readdir(d)) {
+        string name = entry->d_name;
+        size_t separator = name.find("__");
+        if (separator == string::npos || separator == 0 || name.size() <= 4 ||
+            name.compare(name.size() - 4, 4, ".txt") != 0) {
+            continue;
+        }
+        index[name.substr(0, separator)].push_back(dir + "/" + name);
+    }
+    closedir(d);
+    for (auto& entry : index) sort(entry.second.begin(), entry.second.end());
+    return true;
+}
+
+// La mejor de las soluciones de 'files', evaluada. Devuelve false si alguna
+// no se puede leer o no es válida; sin archivos deja sol.tour vacío.
+inline bool loadBestSolution(const vector<string>& files, const TTPInstance& instance,
+                             TTPSolution& sol, bool& withItems) {
+    TTPEvaluator evaluator(instance);
+    sol = TTPSolution();
+    withItems = false;
+    for (const string& file : files) {
+        TTPSolution candidate;
+        bool candidateItems;
+        if (!readSolutionFile(file, instance, candidate, candidateItems)) {
+            return false;
+        }
+        TTPEvaluation ev = evaluator.evaluate(candidate.tour, candidate.pickingPlan);
+        candidate.objective = ev.objective;
+        candidate.profit = ev.profit;
+        candidate.time = ev.time;
+        candidate.weight = ev.weight;
+        if (sol.tour.empty() || candidate.objective > sol.objective) {
+            sol = candidate;
+            withItems = candidateItems;
+        }
+    }
+    return true;
+}
+
+// Solución inicial (warm start) desde 'path': un archivo de solución, o un
+// directorio de --solutions, del que se toma la mejor de las soluciones de
+// la instancia 'label'. Deja la solución evaluada.
+// Devuelve false si el archivo no existe o alguna solución no es válida;
+// si el directorio no tiene ninguna de esa instancia deja sol.tour vacío.
+inline bool loadWarmStart(const string& path, const string& label, const TTPInstance& instance,
+                          TTPSolution& sol, bool& withItems) {
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        SolutionIndex index;
+        if (!indexSolutionDir(path, index)) {
+            return false;
+        }
+        return loadBestSolution(index[fileSlug(label)], instance, sol, withItems);
+    }
+    return loadBestSolution(vector<string>(1, path), instance, sol, withItems);
+}
+
+#endif
@@ -0,0 +1,353 @@
+#ifndef TTP_SWEEP_H
+#define TTP_SWEEP_H
+
+#include "reader.cpp"
+#include "ttp_cache.h"
+#include "base1.h"
+#include <vector>
+#include <string>
+#include <functional>
+#include <fstream>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <glob.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+// ============================================================
+// HEURÍSTICAS COMO FÁBRICAS
+// ============================================================
+// Una heurística se construye para una instancia; el barrido necesita
+// crear las mismas para cada instancia que carga, así que la lista de
+// heurísticas se describe con fábricas: makeFactory<BalancedLNS>(10, 20)
+// crea new BalancedLNS(instancia, 10, 20).
+typedef function<TTPHeuristic*(const TTPInstance&)> HeuristicFactory;
+
+template <typename Heuristic, typename... Args>
+HeuristicFactory makeFactory(Args... args) {
+    return [=](const TTPInstance& inst) -> TTPHeuristic* { return new Heuristic(inst, args...); };
+}
+
+// ============================================================
+// LISTA DE INSTANCIAS DEL BARRIDO
+// ============================================================
+
+// todos los .ttp bajo 'dir', recorriendo subdirectorios
+void findTTPFiles(const string& dir, vector<string>& files) {
+    DIR* d = opendir(dir.c_str());
+    if (!d) return;
+    while (dirent* entry = readdir(d)) {
+        string name = entry->d_name;
+        if (name == "." || name == "..") continue;
+        string path = dir + "/" + name;
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            findTTPFiles(path, files);
+        } else if (name.size() > 4 && name.compare(name.size() - 4, 4, ".ttp") == 0) {
+            files.push_back(path);
+        }
+    }
+    closedir(d);
+}
+
+// Manifiesto: una ruta por línea; se ignoran las líneas vacías y las que
+// empiezan con '#'. Si la línea tiene comillas se toma lo que está entre
+// ellas, así sirve directamente una lista de comandos como la de 'trt'
+// (./simulador "<ruta>").
+bool readManifest(const string& filename, vector<string>& files) {
+    ifstream in(filename);
+    if (!in) {
+        cerr << "Error: No se pudo abrir el manifiesto " << filename << endl;
+        return false;
+    }
+    string line;
+    while (getline(in, line)) {
+        size_t open = line.find('"');
+        if (open != string::npos) {
+            size_t close = line.find('"', open + 1);
+            if (close == string::npos) continue;
+            line = line.substr(open + 1, close - open - 1);
+        } else {
+            size_t first = line.find_first_not_of(" \t\r");
+            size_t last = line.find_last_not_of(" \t\r");
+            line = (first == string::npos) ? "" : line.substr(first, last - first + 1);
+        }
+        if (line.empty() || line[0] == '#') continue;
+        files.push_back(line);
+    }
+    return true;
+}
+
+// 'source' puede ser un directorio (se buscan los .ttp dentro), un patrón
+// con * ? o [ ] (glob) o un manifiesto
+bool collectInstances(const string& source, vector<string>& files) {
+    struct stat st;
+    if (stat(source.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        string dir = source;
+        while (dir.size() > 1 && dir.back() == '/') dir.pop_back();
+        findTTPFiles(dir, files);
+        sort(files.begin(), files.end());
+    } else if (source.find_first_of("*?[") != string::npos) {
+        glob_t matches;
+        if (glob(source.c_str(), 0, nullptr, &matches) == 0) {
+            for (size_t i = 0; i < matches.gl_pathc; i++) files.push_back(matches.gl_pathv[i]);
+        }
+        globfree(&matches);
+    } else if (!readManifest(source, files)) {
+        return false;
+    }
+
+    if (files.empty()) {
+        cerr << "Error: No se encontraron instancias en " << source << endl;
+        return false;
+    }
+    return true;
+}
+
+// ============================================================
+// BARRIDO (INSTANCIA x HEURÍSTICA x RUN) EN UN SOLO PROCESO
+// ============================================================
+// Todos los trabajos se reparten entre los hilos de un ThreadPool. Las
+// instancias se ordenan de mayor a menor (por el tamaño del archivo) para
+// que las ejecuciones largas empiecen primero y las cortas rellenen el
+// final. Cada instancia se carga una sola vez, cuando el primer hilo toma
+// uno de sus trabajos, y se libera cuando termina el último.
+//
+// Con un tope de memoria, antes de cargar una instancia se espera a que
+// la estimación de lo ya cargado más la suya quepa en el tope (siempre se
+// permite una sola instancia, aunque no quepa). Como los trabajos salen en
+// orden, mientras un hilo espera todas las instancias anteriores ya tienen
+// sus trabajos en curso y van a liberar memoria.
+//
+// La semilla de cada trabajo es deriveSeed(semilla, heurística, run), la
+// misma que usa TTPExperiment: una fila del barrido se reproduce corriendo
+// esa instancia sola con la misma --seed. Cada resultado se escribe en el
+// CSV apenas termina.
+class TTPSweep {
+private:
+    // memoria estimada de una instancia cargada más lo que usan sus
+    // ejecuciones, por byte del .ttp (medido con getrusage: la instancia
+    // ocupa ~3 veces el archivo y una ejecución de LNS ~2 veces más)
+    static const int MEMORY_PER_FILE_BYTE = 5;
+
+    enum LoadState { NOT_LOADED, LOADING, LOADED, FAILED };
+
+    struct SweepInstance {
+        string file;
+        uint64_t bytes;                  // memoria estimada
+        LoadState state;
+        int pendingJobs;
+        unique_ptr<TTPInstance> instance;
+        vector<unique_ptr<TTPHeuristic>> heuristics;
+        double bestObjective;
+        string bestHeuristic;
+    };
+
+    vector<SweepInstance> instances;
+    vector<HeuristicFactory> factories;
+    int num_runs;
+    int num_threads;
+    int search_threads;
+    int num_islands;
+    uint64_t master_seed;
+    double time_limit;
+    uint64_t memory_cap;             // bytes (0 = sin tope)
+    string cache_dir;
+    size_t dist_cache_entries;
+    bool warm_start;                 // empezar desde las soluciones de warm_files
+    SolutionIndex warm_files;        // soluciones de un barrido anterior, por instancia
+
+    mutex mtx;
+    condition_variable memoryFreed;
+    condition_variable loaded;
+    uint64_t loadedBytes;
+    int finishedInstances;
+    int failedInstances;
+    ofstream csv;
+    ResultSink sink;
+
+    // cargar la instancia del trabajo (o esperar a que otro hilo la cargue);
+    // false si no se pudo leer
+    bool acquire(SweepInstance& si) {
+        unique_lock<mutex> lock(mtx);
+        if (si.state == NOT_LOADED) {
+            si.state = LOADING;
+            memoryFreed.wait(lock, [&] {
+                return memory_cap == 0 || loadedBytes == 0 || loadedBytes + si.bytes <= memory_cap;
+            });
+            loadedBytes += si.bytes;
+            lock.unlock();
+
+            unique_ptr<TTPInstance> instance(new TTPInstance());
+            bool ok = loadInstance(si.file, *instance, cache_dir);
+            TTPSolution start;
+            bool withItems = false;
+            if (ok && warm_start) {
+                auto found = warm_files.find(fileSlug(instanceLabel(si.file)));
+                if (found != warm_files.end()) {
+                    ok = loadBestSolution(found->second, *instance, start, withItems);
+                }
+            }
+            if (ok) {
+                instance->distances.enableCache(dist_cache_entries);
+                for (const HeuristicFactory& make : factories) {
+                    si.heuristics.emplace_back(make(*instance));
+                    if (!start.tour.empty()) si.heuristics.back()->setWarmStart(start, withItems);
+                }
+            }
+
+            lock.lock();
+            si.instance.swap(instance);
+            si.state = ok ? LOADED : FAILED;
+            loaded.notify_all();
+        } else {
+            loaded.wait(lock, [&] { return si.state == LOADED || si.state == FAILED; });
+        }
+        return si.state == LOADED;
+    }
+
+    // el trabajo terminó; con el último de la instancia se libera
+    void release(SweepInstance& si) {
+        lock_guard<mutex> lock(mtx);
+        if (--si.pendingJobs > 0) return;
+
+        finishedInstances++;
+        if (si.state == FAILED) {
+            failedInstances++;
+        } else {
+            cout << "[" << finishedInstances << "/" << instances.size() << "] " << si.file
+                 << ": mejor objetivo " << si.bestObjective << " (" << si.bestHeuristic << ")" << endl;
+        }
+        si.heuristics.clear();
+        si.instance.reset();
+        loadedBytes -= si.bytes;
+        memoryFreed.notify_all();
+    }
+
+    void runJob(int job) {
+        int jobsPerInstance = factories.size() * num_runs;
+        SweepInstance& si = instances[job / jobsPerInstance];
+        int h = job % jobsPerInstance / num_runs;
+        int run = job % num_runs;
+
+        if (acquire(si)) {
+            uint64_t seed = deriveSeed(master_seed, h, run);
+            unique_ptr<TTPHeuristic> worker(si.heuristics[h]->clone());
+            worker->setSeed(seed);
+            worker->setSearchThreads(search_threads);
+            worker->setIslands(num_islands);
+            worker->startClock(time_limit);
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            TTPSolution sol = worker->solve();
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            if (sink.isOpen()) {
+                sink.submit({instanceLabel(si.file), worker->getName(), run + 1, seed, sol});
+            }
+
+            lock_guard<mutex> lock(mtx);
+            const TTPInstance& inst = *si.instance;
+            csv << "\"" << si.file << "\"," << inst.name << "," << inst.dimension << ","
+                << inst.num_items << ",\"" << worker->getName() << "\"," << (run + 1) << ","
+                << seed << "," << sol.objective << "," << sol.profit << "," << sol.time << ","
+                << sol.weight << "," << seconds << "," << worker->getCounters().evaluations << endl;
+            if (sol.objective > si.bestObjective) {
+                si.bestObjective = sol.objective;
+                si.bestHeuristic = worker->getName();
+            }
+        }
+        release(si);
+    }
+
+public:
+    TTPSweep(const vector<string>& files, const vector<HeuristicFactory>& heuristics, int runs = 1)
+        : factories(heuristics), num_runs(runs), num_threads(1), search_threads(1), num_islands(1),
+          master_seed(time(0)), time_limit(0), memory_cap(0), cache_dir(".ttp_cache"),
+          dist_cache_entries(0), warm_start(false), loadedBytes(0), finishedInstances(0), failedInstances(0) {
+        for (const string& file : files) {
+            SweepInstance si;
+            struct stat st;
+            si.file = file;
+            si.bytes = (stat(file.c_str(), &st) == 0) ? (uint64_t)st.st_size * MEMORY_PER_FILE_BYTE : 0;
+            si.state = NOT_LOADED;
+            si.pendingJobs = factories.size() * num_runs;
+            si.bestObjective = -numeric_limits<double>::infinity();
+            instances.push_back(move(si));
+        }
+        stable_sort(instances.begin(), instances.end(), [](const SweepInstance& a, const SweepInstance& b) {
+            return a.bytes > b.bytes;
+        });
+    }
+
+    void setThreads(int threads) { num_threads = max(1, threads); }
+    void setSearchThreads(int threads) { search_threads = max(1, threads); }
+    void setIslands(int count) { num_islands = max(1, count); }
+    void setSeed(uint64_t seed) { master_seed = seed; }
+    void setTimeLimit(double seconds) { time_limit = max(0.0, seconds); }
+    void setMemoryCapMB(uint64_t megabytes) { memory_cap = megabytes << 20; }
+    void setCacheDir(const string& dir) { cache_dir = dir; }
+    void setDistCache(size_t entries) { dist_cache_entries = entries; }
+    
+    // empezar cada instancia desde la mejor de sus soluciones en dir (la
+    // salida de --solutions de otro barrido); las que no tienen ninguna
+    // empiezan de cero. El directorio se indexa aquí una sola vez.
+    bool setWarmStart(const string& dir) {
+        struct stat st;
+        if (stat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+            cerr << "Error: --warm-start en modo --batch debe ser un directorio de --solutions: " << dir << endl;
+            return false;
+        }
+        warm_files.clear();
+        warm_start = indexSolutionDir(dir, warm_files);
+        return warm_start;
+    }
+    
+    // escribir la solución de cada trabajo en dir (ttp_sink.h)
+    bool setSolutionDir(const string& dir) { return sink.open(dir); }
+
+    // corre todo el barrido escribiendo una fila por trabajo en csvFile
+    bool run(const string& csvFile) {
+        csv.open(csvFile);
+        if (!csv) {
+            cerr << "Error: No se pudo escribir los resultados en " << csvFile << endl;
+            return false;
+        }
+        csv << "archivo,instancia,ciudades,items,heuristica,run,semilla,objetivo,ganancia,tiempo,peso,segundos,evaluaciones" << endl;
+        csv.precision(10);
+
+        int numJobs = instances.size() * factories.size() * num_runs;
+        cout << "\n---------------------------------------" << endl;
+        cout << "       BARRIDO TTP" << endl;
+        cout << "Instancias: " << instances.size() << endl;
+        cout << "Heuristicas: " << factories.size() << endl;
+        cout << "Ejecuciones por heuristica: " << num_runs << endl;
+        cout << "Trabajos: " << numJobs << endl;
+        cout << "Hilos: " << num_threads << endl;
+        if (memory_cap > 0) {
+            cout << "Tope de memoria: " << (memory_cap >> 20) << " MB" << endl;
+        }
+        cout << "Semilla maestra: " << master_seed << endl;
+        cout << "Resultados: " << csvFile << endl;
+        cout << "-----------------------------------------\n" << endl;
+
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        ThreadPool pool(num_threads);
+        pool.parallelFor(numJobs, [&](int job) { runJob(job); });
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cout << "\nBarrido terminado en " << seconds << " s" << endl;
+        if (!sink.close()) {
+            return false;
+        }
+        if (failedInstances > 0) {
+            cerr << "Error: " << failedInstances << " instancias no se pudieron leer" << endl;
+            return false;
+        }
+        return true;
+    }
+};
+
+#endif
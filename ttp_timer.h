@@ -0,0 +1,62 @@
+#ifndef TTP_TIMER_H
+#define TTP_TIMER_H
+
+#include <chrono>
+
+using namespace std;
+
+// ============================================================
+// PRESUPUESTO DE TIEMPO (reloj monótono)
+// ============================================================
+// expired() se llama desde los bucles internos de las búsquedas, así que
+// solo consulta el reloj cada CHECK_INTERVAL llamadas; una vez agotado el
+// tiempo sigue devolviendo true sin volver a mirarlo.
+class Deadline {
+private:
+    static const int CHECK_INTERVAL = 64;
+
+    chrono::steady_clock::time_point start;
+    chrono::steady_clock::time_point finish;
+    bool limited;
+    bool reached;
+    int countdown;
+
+public:
+    Deadline() : start(chrono::steady_clock::now()), finish(start),
+                 limited(false), reached(false), countdown(0) {}
+
+    // empezar a contar; seconds <= 0 significa sin límite
+    void restart(double seconds) {
+        start = chrono::steady_clock::now();
+        limited = seconds > 0;
+        reached = false;
+        countdown = 0;
+        finish = start + chrono::duration_cast<chrono::steady_clock::duration>(
+                             chrono::duration<double>(seconds > 0 ? seconds : 0));
+    }
+
+    bool isLimited() const { return limited; }
+
+    bool expired() {
+        if (!limited) return false;
+        if (reached) return true;
+        if (--countdown > 0) return false;
+        countdown = CHECK_INTERVAL;
+        reached = chrono::steady_clock::now() >= finish;
+        return reached;
+    }
+
+    // igual que expired() pero mirando siempre el reloj; para bucles
+    // externos donde cada iteración ya es costosa
+    bool expiredNow() {
+        countdown = 0;
+        return expired();
+    }
+
+    // segundos desde restart()
+    double elapsed() const {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+};
+
+#endif